@@ -0,0 +1,217 @@
+// Host проверка на OLED екраните: истинският DisplayManager (Adafruit
+// буферът и I2C са от hal/native/) рисува нормалния екран и екраните на
+// сушенето много кадри подред, а брояч на heap алокациите (malloc и new)
+// очаква 0 на кадър. Сверява и форматирането (DisplayFormat) с printf.
+// При разлика връща код 1.
+//
+// Build & run (Linux/glibc, от корена на проекта) - програмата на env:native_display:
+//   pio run -e native_display && .pio/build/native_display/program
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "DisplayFormat.h"
+#include "DisplayManager.h"
+#include "DryingSessionManager.h"
+#include "Sparkline.h"
+#include "StorageManager.h"
+
+// ============= Брояч на алокации =============
+
+extern "C" void* __libc_malloc(size_t size);
+
+static bool counting = false;
+static size_t allocationCount = 0;
+
+extern "C" void* malloc(size_t size) {
+    if (counting) allocationCount++;
+    return __libc_malloc(size);
+}
+
+void* operator new(size_t size) {
+    if (counting) allocationCount++;
+    void* p = __libc_malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ============= Проверки =============
+
+static int failures = 0;
+
+static void expect(const char* what, const char* actual, const char* expected) {
+    if (strcmp(actual, expected) != 0) {
+        printf("FAIL %-28s got \"%s\", expected \"%s\"\n", what, actual, expected);
+        failures++;
+    }
+}
+
+static void checkWeights() {
+    // Както старото String(weight, n) в showNormalWeight
+    static const struct {
+        float grams;
+        uint8_t unit;
+        const char* expected;
+    } CASES[] = {
+        { 0.0f,     0, "0.0" },
+        { 1.9f,     0, "0.0" },
+        { -1.5f,    0, "0.0" },
+        { 2.5f,     0, "2.5" },
+        { 523.46f,  0, "523.5" },
+        { -42.04f,  0, "-42.0" },
+        { 999.94f,  0, "999.9" },
+        { 1234.9f,  0, "1234" },
+        { -2500.0f, 0, "-2500" },
+        { 1.0f,     1, "0.0" },
+        { 1234.4f,  1, "1.234" },
+        { 25000.0f, 1, "25.000" },
+        { 1.0f,     2, "0.0" },
+        { 100.0f,   2, "3.53" },
+        { 1000.0f,  3, "2.205" },
+    };
+
+    char text[16];
+    for (const auto& c : CASES) {
+        formatWeight(text, sizeof(text), c.grams, c.unit);
+        char what[40];
+        snprintf(what, sizeof(what), "weight %.2f %s", c.grams, unitFormat(c.unit).suffix);
+        expect(what, text, c.expected);
+    }
+}
+
+static void checkFixedAgainstPrintf() {
+    // Разлики до половин последна цифра са закръгляне на float, не грешка
+    char ours[24];
+    char reference[24];
+    srand(1);
+    for (int i = 0; i < 100000; i++) {
+        float v = (rand() % 2000000 - 1000000) / 37.0f;
+        uint8_t decimals = i % 4;
+        formatFixed(ours, sizeof(ours), v, decimals);
+        snprintf(reference, sizeof(reference), "%.*f", decimals, v);
+        if (strcmp(ours, reference) != 0 && fabs(atof(ours) - atof(reference)) > pow(10, -decimals) * 1.01) {
+            printf("FAIL fixed %.6f/%u: got \"%s\", printf \"%s\"\n", v, decimals, ours, reference);
+            if (++failures > 10) return;
+        }
+    }
+}
+
+static void checkLayout() {
+    LayoutCache layouts(128, 64);
+    const TextLayout& shortWeight = layouts.weight(5);    // "523.5"
+    const TextLayout& longWeight = layouts.weight(7);     // "-25.000"
+    if (shortWeight.size != 3 || shortWeight.x != 19 || shortWeight.y != 15) {
+        printf("FAIL layout 5: size %u x %d y %d\n", shortWeight.size, shortWeight.x, shortWeight.y);
+        failures++;
+    }
+    if (longWeight.size != 2 || longWeight.x != 22) {
+        printf("FAIL layout 7: size %u x %d\n", longWeight.size, longWeight.x);
+        failures++;
+    }
+    if (layouts.centeredX(2, 9) != 10 || layouts.centeredX(1, 7) != 43) {
+        printf("FAIL centeredX\n");
+        failures++;
+    }
+}
+
+// ============= Екраните =============
+
+static StorageManager storage;
+static DryingSessionManager drying(storage);
+static DisplayManager display;
+static Sparkline dayGraph(Sparkline::MODE_WINDOW, 24UL * 3600);
+static Sparkline lossGraph(Sparkline::MODE_SESSION, 60);
+
+// 60-дневна сесия и пълни графики - най-дългият текст и всички колони
+static void fillSession() {
+    DryingSession& session = drying.getSession();
+    memset(&session, 0, sizeof(session));
+    session.isActive = true;
+    session.initialWeight = 5000.0f;
+    session.targetLossPercent = 40.0f;
+    session.startTimestamp = 1000;
+
+    float weight = session.initialWeight;
+    for (uint8_t i = 0; i < MAX_DAILY_RECORDS; i++) {
+        float change = weight * 0.012f;
+        weight -= change;
+        DailyRecord& record = session.records[i];
+        record.day = i + 1;
+        record.timestamp = session.startTimestamp + i * 86400UL;
+        record.weight = weight;
+        record.lossPercent = (session.initialWeight - weight) / session.initialWeight * 100.0f;
+        record.dayChange = change;
+    }
+    session.recordCount = MAX_DAILY_RECORDS;
+    session.currentDay = MAX_DAILY_RECORDS;
+    session.lastRecordTimestamp = session.records[MAX_DAILY_RECORDS - 1].timestamp;
+
+    const uint32_t now = 60UL * 86400;
+    dayGraph.reset();
+    lossGraph.reset(session.startTimestamp);
+    for (uint32_t t = session.startTimestamp; t <= now; t += 600) {
+        float w = session.initialWeight * (1.0f - 0.45f * (t / (float)now));
+        if (t > now - 86400) dayGraph.add(t, w);
+        lossGraph.add(t, (session.initialWeight - w) / session.initialWeight * 100.0f);
+    }
+}
+
+// Тегло и единица се менят всеки кадър, за да се рисува нов текст
+static float frameWeight(uint32_t frame) {
+    return (frame % 50000) / 7.0f - 1000.0f;
+}
+
+static const struct {
+    const char* name;
+    void (*draw)(uint32_t frame);
+} SCREENS[] = {
+    { "showNormalWeight",  [](uint32_t frame) {
+        display.showNormalWeight(frameWeight(frame), (ScaleManager::WeightUnit)(frame % 4));
+    } },
+    { "showDryingLive",    [](uint32_t frame) { display.showDryingLive(drying, 3000.0f + frameWeight(frame)); } },
+    { "showDryingStats",   [](uint32_t) { display.showDryingStats(drying); } },
+    { "showDryingHistory", [](uint32_t frame) { display.showDryingHistory(drying, frame % MAX_DAILY_RECORDS); } },
+    { "showDryingGraph",   [](uint32_t) { display.showDryingGraph(drying, dayGraph, lossGraph); } },
+};
+
+int main() {
+    checkWeights();
+    checkFixedAgainstPrintf();
+    checkLayout();
+
+    hostSerialQuiet = true;
+    display.begin();
+    fillSession();
+    const uint32_t frames = 20000;
+
+    for (const auto& screen : SCREENS) {
+        // Първият кадър извън броенето - еднократните буфери (stdout и т.н.)
+        screen.draw(0);
+
+        counting = true;
+        allocationCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 1; i <= frames; i++) {
+            screen.draw(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        counting = false;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / frames;
+        printf("%-18s %8.1f ns/frame, %zu allocations in %u frames\n", screen.name, ns, allocationCount, frames);
+        if (allocationCount != 0) {
+            printf("FAIL %s allocated\n", screen.name);
+            failures++;
+        }
+    }
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,395 @@
+// Симулатор на сушене с ускорено време: модел на тензодатчика (парчета с
+// експоненциална загуба на влага, шум, дрейф, отваряне на вратата) подава
+// отчети през HX711 от hal/native/ на истинските ScaleManager,
+// DryingSessionManager, StorageManager, UiController и AlertManager.
+// Виртуалният часовник прескача по една проба, така че 60-дневна сесия
+// (с автоматичните дневни записи на 24 ч) минава за секунди.
+//
+// Отчита: дневните записи спрямо истинското тегло, точността на ETA
+// (estimateDaysRemaining) спрямо деня, в който моделът достига целта,
+// алармите и растежа на файловете (LittleFS) и NVS записите.
+//
+// Проверява и времето на записите: разстояние 24 ч +- една проба и растящи
+// timestamp-и. Сесията минава 49.7 дни, където millis() се превърта -
+// нарушенията са отбелязани с "!" и програмата връща код 1.
+//
+// Build & run (Linux, от корена на проекта) - програмата на env:native_sim:
+//   pio run -e native_sim && .pio/build/native_sim/program [опции]
+// или без PlatformIO (ArduinoJson 6 от .pio/libdeps/native или друго копие):
+//   g++ -O2 -std=gnu++17 -Ihal/native -Iinclude -I<ArduinoJson>/src bench/drying_sim.cpp hal/native/*.cpp
+//       $(ls src/*.cpp | grep -v -e main.cpp -e WebServer -e WebAssets) -o drying_sim
+//
+// Опции (по подразбиране в скоби):
+//   -d <дни>        продължителност (60)
+//   -p <брой>       окачени парчета (6)
+//   -t <%>          целева загуба (40)
+//   -s <секунди>    интервал между пробите (10; фърмуерът чете на 0.5 s)
+//   -n <g>          шум, стандартно отклонение (0.8)
+//   -r <g/ден>      дрейф на нулата (1.5)
+//   -T <g>          дневно колебание от температурата (3)
+//   -o <брой/ден>   отваряния на вратата (2)
+//   -x <seed>       seed на модела (1)
+//   -v              лог на фърмуера на stdout
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "ScaleManager.h"
+#include "StorageManager.h"
+#include "DryingSessionManager.h"
+#include "DisplayManager.h"
+#include "ButtonHandler.h"
+#include "UiController.h"
+#include "AlertManager.h"
+#include "EventBus.h"
+#include "Metrics.h"
+#include "HX711.h"
+#include "LittleFS.h"
+
+static const uint64_t DAY_MS = 86400000ULL;
+static const long RAW_OFFSET = 84210;       // Празен кантар
+static const float RAW_PER_GRAM = 420.0f;   // 5 kg клетка, gain 128
+static const float RACK_GRAMS = 250.0f;     // Окачването - тарира се преди сесията
+static const uint8_t MAX_PIECES = 32;
+static const uint8_t MAX_DOORS = 255;
+
+static ScaleManager scale(18, 19);
+static StorageManager storage;
+static DryingSessionManager drying(storage);
+static DisplayManager display;
+static ButtonHandler buttons(33, 25, 26);
+static UiController ui(display, buttons, drying, scale);
+static AlertManager alerts;
+
+static const AlertManager::RuleConfig ALERT_RULES[] = {
+    { "ready", AlertManager::ALERT_READY,   0.0f,  0,         AlertManager::ACTION_BANNER, 60000, 6UL * 3600000 },
+    { "stall", AlertManager::ALERT_STALL,   2.0f,  12 * 3600, AlertManager::ACTION_BANNER, 0,     12UL * 3600000 },
+    { "jump",  AlertManager::ALERT_ANOMALY, 50.0f, 0,         AlertManager::ACTION_BANNER, 900000, 60000 },
+};
+
+// ============= Модел =============
+
+struct Options {
+    uint32_t days = 60;
+    uint8_t pieces = 6;
+    float targetLoss = 40.0f;
+    uint32_t sampleSec = 10;
+    float noise = 0.8f;
+    float driftPerDay = 1.5f;
+    float tempAmplitude = 3.0f;
+    float doorsPerDay = 2.0f;
+    uint32_t seed = 1;
+    bool verbose = false;
+};
+
+// Парче: m(t) = m0 * (1 - L * (1 - e^(-t/tau)))
+struct Piece {
+    float mass;
+    float maxLoss;       // Дял вода, който може да излезе
+    float tauDays;
+};
+
+// Отворена врата: течение и докосване - отместване и повече шум
+struct DoorEvent {
+    uint64_t startMs;
+    uint64_t endMs;
+    float push;          // g
+};
+
+static Options options;
+static Piece pieces[MAX_PIECES];
+static DoorEvent doors[MAX_DOORS];
+static uint16_t doorCount = 0;
+static uint64_t hangMs = 0;          // Парчетата са окачени
+static uint32_t rng = 1;
+
+static float uniform() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static float uniform(float low, float high) {
+    return low + (high - low) * uniform();
+}
+
+static float gaussian() {
+    float u = uniform() + 1e-7f;
+    return sqrtf(-2.0f * logf(u)) * cosf(2.0f * (float)M_PI * uniform());
+}
+
+// Тегло на парчетата без шум (истината, с която се сравнява)
+static float productGrams(uint64_t timeMs) {
+    if (timeMs < hangMs) {
+        return 0.0f;
+    }
+    float days = (timeMs - hangMs) / (float)DAY_MS;
+    float total = 0.0f;
+    for (uint8_t i = 0; i < options.pieces; i++) {
+        const Piece& p = pieces[i];
+        total += p.mass * (1.0f - p.maxLoss * (1.0f - expf(-days / p.tauDays)));
+    }
+    return total;
+}
+
+static float productInitialGrams() {
+    float total = 0.0f;
+    for (uint8_t i = 0; i < options.pieces; i++) total += pieces[i].mass;
+    return total;
+}
+
+static const DoorEvent* doorAt(uint64_t timeMs) {
+    for (uint16_t i = 0; i < doorCount; i++) {
+        if (timeMs >= doors[i].startMs && timeMs < doors[i].endMs) return &doors[i];
+    }
+    return nullptr;
+}
+
+// Отчетът на HX711 в момента timeMs
+static long modelRaw(uint64_t timeMs) {
+    float days = timeMs / (float)DAY_MS;
+    float grams = RACK_GRAMS + productGrams(timeMs);
+    grams += options.driftPerDay * days;
+    grams += options.tempAmplitude * sinf(2.0f * (float)M_PI * days);
+
+    float noise = options.noise;
+    const DoorEvent* door = doorAt(timeMs);
+    if (door) {
+        grams += door->push;
+        noise *= 10.0f;
+    }
+    grams += noise * gaussian();
+    return RAW_OFFSET + lroundf(grams * RAW_PER_GRAM);
+}
+
+static void buildModel() {
+    rng = options.seed ? options.seed : 1;
+    for (uint8_t i = 0; i < options.pieces; i++) {
+        pieces[i].mass = uniform(400.0f, 1600.0f);
+        pieces[i].maxLoss = uniform(0.42f, 0.55f);
+        pieces[i].tauDays = uniform(10.0f, 24.0f);
+    }
+
+    // Поасонов поток: експоненциални интервали между отварянията
+    doorCount = 0;
+    uint64_t t = 0;
+    uint64_t end = (uint64_t)options.days * DAY_MS;
+    while (options.doorsPerDay > 0 && doorCount < MAX_DOORS) {
+        t += (uint64_t)(-logf(uniform() + 1e-7f) / options.doorsPerDay * DAY_MS);
+        if (t >= end) break;
+        DoorEvent& door = doors[doorCount++];
+        door.startMs = t;
+        door.endMs = t + (uint64_t)uniform(60000.0f, 600000.0f);
+        door.push = uniform(-60.0f, 60.0f);
+    }
+}
+
+// Първият момент (на минута), в който истинската загуба достига целта
+static double trueReadyDay(uint64_t startMs, float initial) {
+    uint64_t end = startMs + (uint64_t)options.days * DAY_MS * 3;
+    for (uint64_t t = startMs; t < end; t += 60000) {
+        if ((initial - productGrams(t)) / initial * 100.0f >= options.targetLoss) {
+            return (t - startMs) / (double)DAY_MS;
+        }
+    }
+    return -1.0;
+}
+
+// ============= Фърмуер =============
+
+struct RecordLog {
+    uint8_t day;
+    uint64_t timeMs;
+    uint32_t timestamp;      // Записаният от фърмуера (s)
+    float weight;
+    float trueWeight;
+    float lossPercent;
+    int eta;
+    size_t fsUsed;
+};
+
+static RecordLog records[MAX_DAILY_RECORDS];
+static uint8_t recordLogCount = 0;
+static uint32_t anomalies = 0;
+static uint32_t samples = 0;
+static float currentWeight = 0.0f;
+static uint64_t sessionStartMs = 0;
+
+static void onRecord(const RecordAddedEvent& e, void*) {
+    if (recordLogCount >= MAX_DAILY_RECORDS) return;
+    RecordLog& log = records[recordLogCount++];
+    log.day = e.day;
+    log.timeMs = hostTime();
+    log.timestamp = e.timestamp;
+    log.weight = e.weight;
+    log.trueWeight = productGrams(hostTime());
+    log.lossPercent = e.lossPercent;
+    log.eta = drying.estimateDaysRemaining();
+    log.fsUsed = LittleFS.usedBytes();
+}
+
+static void onAnomaly(const AnomalyDetectedEvent&, void*) {
+    anomalies++;
+}
+
+// Пробата и UI частта на loop() в main.cpp
+static void runLoopOnce() {
+    float weight = scale.getRawWeight();
+    if (!isnan(weight)) {
+        currentWeight = weight;
+        samples++;
+        ui.addSample(hostTime() / 1000, currentWeight);
+        alerts.evaluate(drying, currentWeight);
+    }
+    alerts.update();
+
+    ui.update(currentWeight, false);
+    buttons.update(scale, drying, display);
+    ui.applyRequests(buttons.popUiRequests());
+}
+
+static void runUntil(uint64_t target) {
+    uint64_t step = (uint64_t)options.sampleSec * 1000;
+    while (hostTime() < target) {
+        uint64_t next = hostTime() + step;
+        hostSetTime(next < target ? next : target);
+        runLoopOnce();
+    }
+}
+
+static bool parseOptions(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "d:p:t:s:n:r:T:o:x:v")) != -1) {
+        switch (opt) {
+            case 'd': options.days = atoi(optarg); break;
+            case 'p': options.pieces = (uint8_t)atoi(optarg); break;
+            case 't': options.targetLoss = atof(optarg); break;
+            case 's': options.sampleSec = atoi(optarg); break;
+            case 'n': options.noise = atof(optarg); break;
+            case 'r': options.driftPerDay = atof(optarg); break;
+            case 'T': options.tempAmplitude = atof(optarg); break;
+            case 'o': options.doorsPerDay = atof(optarg); break;
+            case 'x': options.seed = strtoul(optarg, nullptr, 10); break;
+            case 'v': options.verbose = true; break;
+            default: return false;
+        }
+    }
+    return options.days > 0 && options.days <= MAX_DAILY_RECORDS &&
+           options.pieces > 0 && options.pieces <= MAX_PIECES && options.sampleSec > 0;
+}
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv)) {
+        fprintf(stderr, "usage: drying_sim [-d days<=%d] [-p pieces<=%d] [-t loss%%] [-s sample_s] [-n noise_g]\n"
+                        "                  [-r drift_g_day] [-T temp_g] [-o doors_day] [-x seed] [-v]\n",
+                MAX_DAILY_RECORDS, MAX_PIECES);
+        return 2;
+    }
+    hostSerialQuiet = !options.verbose;
+    buildModel();
+    HX711::hostSource = modelRaw;
+    EventBus::subscribe<RecordAddedEvent>(onRecord);
+    EventBus::subscribe<AnomalyDetectedEvent>(onAnomaly);
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    // Стартът: празно окачване, тариране, парчетата след минута
+    display.begin();
+    scale.begin();
+    scale.applyCalibration(RAW_OFFSET, RAW_PER_GRAM);
+    storage.begin();
+    drying.begin();
+    buttons.begin();
+    alerts.begin(ALERT_RULES, sizeof(ALERT_RULES) / sizeof(ALERT_RULES[0]));
+    hangMs = 120000;
+    hostSetTime(60000);
+    scale.performTare();
+    runUntil(hangMs + 60000);
+
+    sessionStartMs = hostTime();
+    if (!buttons.startSession(scale, drying, display, options.targetLoss)) {
+        fprintf(stderr, "session did not start\n");
+        return 1;
+    }
+    ui.applyRequests(buttons.popUiRequests());
+    float initial = drying.getSession().initialWeight;
+
+    runUntil(sessionStartMs + (uint64_t)options.days * DAY_MS);
+    drying.endSession();
+
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double simSec = hostTime() / 1000.0;
+
+    // ============= Отчет =============
+
+    hostSerialQuiet = false;
+    double readyDay = trueReadyDay(sessionStartMs, productInitialGrams());
+    printf("%u pieces, %.1f g (firmware %.1f g), target -%.1f%%, model reaches it on day %.2f\n",
+           options.pieces, productInitialGrams(), initial, options.targetLoss, readyDay);
+    printf("%u door openings, %u samples\n\n", doorCount, samples);
+
+    printf(" day  elapsed   weight     true    error   loss%%  ETA  pred.day  fs used\n");
+    double etaErrorSum = 0.0;
+    uint32_t etaCount = 0;
+    float maxError = 0.0f;
+    int firstReady = -1;
+    uint32_t badSpacing = 0;
+    uint32_t backwards = 0;
+    for (uint8_t i = 0; i < recordLogCount; i++) {
+        const RecordLog& r = records[i];
+        // Първият запис е при старта, следващите - на 24 ч (с точност до проба)
+        bool spacingBad = false;
+        bool timestampBad = false;
+        if (i > 0) {
+            int64_t spacing = (int64_t)(r.timeMs - records[i - 1].timeMs) - (int64_t)DAY_MS;
+            spacingBad = llabs(spacing) > (int64_t)options.sampleSec * 1000;
+            timestampBad = r.timestamp < records[i - 1].timestamp;
+            badSpacing += spacingBad;
+            backwards += timestampBad;
+        }
+        const char* mark = spacingBad && timestampBad ? " ! spacing, timestamp" :
+                           spacingBad ? " ! spacing" : timestampBad ? " ! timestamp" : "";
+        double elapsed = (r.timeMs - sessionStartMs) / (double)DAY_MS;
+        float error = r.weight - r.trueWeight;
+        if (fabsf(error) > fabsf(maxError)) maxError = error;
+        if (firstReady < 0 && r.lossPercent >= options.targetLoss) firstReady = i;
+
+        char predicted[16] = "-";
+        if (r.eta >= 0) {
+            double day = elapsed + r.eta;
+            snprintf(predicted, sizeof(predicted), "%.1f", day);
+            // След истинската готовност ETA=0 не е прогноза
+            if (readyDay >= 0 && elapsed < readyDay) {
+                etaErrorSum += fabs(day - readyDay);
+                etaCount++;
+            }
+        }
+        printf("%4u %7.2fd %8.1f %8.1f %+8.1f %7.1f %4d %9s %8zu%s\n", r.day, elapsed, r.weight,
+               r.trueWeight, error, r.lossPercent, r.eta, predicted, r.fsUsed, mark);
+    }
+
+    printf("\nrecords: %u in %u days, largest record error %+.1f g\n", recordLogCount, options.days, maxError);
+    printf("record timing: %u spaced outside 24 h +- %u s, %u timestamps going backwards\n",
+           badSpacing, options.sampleSec, backwards);
+    if (firstReady >= 0) {
+        printf("ready: firmware on day %.2f (model %.2f)\n",
+               (records[firstReady].timeMs - sessionStartMs) / (double)DAY_MS, readyDay);
+    } else {
+        printf("ready: not reached by the firmware\n");
+    }
+    if (etaCount > 0) {
+        printf("ETA: mean absolute error %.2f days over %u estimates before the model was ready\n",
+               etaErrorSum / etaCount, etaCount);
+    }
+    printf("alerts: %u fired (%u anomalies)\n", alerts.getFireCount(), anomalies);
+    printf("storage: %zu of %zu bytes used, %u bytes written, %u file writes, %u NVS writes\n",
+           LittleFS.usedBytes(), LittleFS.totalBytes(), metrics.fsBytesWritten.get(),
+           LittleFS.hostWrites(), metrics.nvsWrites.get());
+    printf("%.1f simulated days in %.2f s (%.0fx real time)\n", simSec / 86400.0, wallSec, simSec / wallSec);
+    return badSpacing + backwards > 0 ? 1 : 0;
+}
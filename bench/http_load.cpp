@@ -0,0 +1,524 @@
+// Host load test за JSON API-то на кантара.
+//
+// JSON маршрутите на WebServerManager (ApiHandler: кеш по поколение,
+// ETag/304, /series през seqlock-а на SampleLog) и /metrics зад локален
+// TCP сокет - същият код като на устройството, без ESPAsyncWebServer.
+// Както async_tcp, всички връзки се обслужват от една нишка; отделна
+// нишка играе loop() (проби на 500 ms).
+//
+// N клиента повтарят заявките на страниците:
+//   monitor - /status/data на всеки такт, /series?src=samples на 60 такта
+//   history - /history/data на всеки такт, /series?src=records на 30 такта
+// Браузърът пази ETag-а и праща If-None-Match, така че непромененото
+// състояние връща 304.
+//
+// Отчита заявки/s, p50/p99 латентност (при клиента), време в handler-а и
+// heap алокации на заявка (в сървърната нишка), както и отклонението на
+// пробите - дали товарът забавя "loop()". С --one-core всички нишки са на
+// едно ядро, по-близо до ESP32, където loop() и async_tcp делят процесора.
+//
+// Build & run (Linux, от корена на проекта):
+//   g++ -O2 -std=c++17 -pthread -Iinclude bench/http_load.cpp src/ApiHandler.cpp src/JsonWriter.cpp
+//       src/WebApi.cpp src/Downsampler.cpp src/SampleLog.cpp src/Metrics.cpp -o http_load
+//   ./http_load -c 8 -d 10 -i 100
+//     -c клиенти (8), -d секунди (10), -i ms между тактовете на клиент (0 = без пауза)
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <new>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "ApiHandler.h"
+
+using Clock = std::chrono::steady_clock;
+
+// ============= Брояч на алокации (само в handler-ите) =============
+
+static thread_local bool countAllocations = false;
+static thread_local size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    if (countAllocations) allocationCount++;
+    void* p = malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ============= Маршрути =============
+
+enum LoadRoute : uint8_t {
+    LR_STATUS,
+    LR_HISTORY,
+    LR_SERIES_SAMPLES,
+    LR_SERIES_RECORDS,
+    LR_METRICS,
+    LR_OTHER,
+    LR_COUNT
+};
+
+static const char* const LOAD_ROUTE_NAMES[LR_COUNT] = {
+    "/status/data", "/history/data", "/series samples", "/series records", "/metrics", "other"
+};
+
+struct HandlerStats {
+    uint32_t requests;
+    uint32_t codes[4];       // 200, 304, 4xx, 5xx
+    uint64_t handlerNs;
+    uint64_t allocations;
+    uint64_t bodyBytes;
+};
+
+// ============= Състоянието (ApiHandler, като в WebServerManager) =============
+
+struct Response {
+    int code;
+    const char* contentType;
+    const char* body;
+    char etag[24];
+};
+
+static ApiHandler api;
+static SampleLog sampleLog;
+
+// "loop()": 24 ч минутни проби и 30 дни сушене
+static void fillState(uint32_t now) {
+    for (uint32_t t = now - SAMPLE_LOG_CAPACITY * SAMPLE_LOG_INTERVAL; t < now; t += SAMPLE_LOG_INTERVAL) {
+        sampleLog.addReading(t, 3800.0f + 40.0f * sinf(t / 7200.0f));
+    }
+    DailyRecord records[30];
+    float weight = 5000.0f;
+    for (uint8_t i = 0; i < 30; i++) {
+        float change = weight * 0.012f;
+        weight -= change;
+        records[i].day = i + 1;
+        records[i].timestamp = now - (30 - i) * 86400;
+        records[i].weight = weight;
+        records[i].lossPercent = (5000.0f - weight) / 50.0f;
+        records[i].dayChange = change;
+    }
+    api.publishRecords(records, 30, true, now - 31 * 86400);
+}
+
+static void publishWeight(float weight) {
+    StatusSnapshot next;
+    memset(&next, 0, sizeof(next));
+    next.active = true;
+    next.initialWeight = 5000.0f;
+    next.currentWeight = weight;
+    next.targetLoss = 40.0f;
+    next.currentDay = 31;
+    next.recordCount = 30;
+    next.daysRemaining = 12;
+    api.publishStatus(next);
+}
+
+// HTTP нишката: JSON маршрутите са в ApiHandler, /metrics - като handleMetrics()
+static void handle(LoadRoute route, const char* query, const char* ifNoneMatch, Response& out) {
+    out.code = 200;
+    out.contentType = "application/json";
+    out.etag[0] = '\0';
+
+    if (route == LR_METRICS) {
+        MetricsGauges gauges = { 0, 200000, 150000, 110000, -60, true, nullptr, 0 };
+        out.contentType = "text/plain; version=0.0.4";
+        out.body = writeMetrics(api.getBulkBuffer(), api.getBulkSize(), metrics, gauges) ? api.getBulkBuffer() : "";
+        return;
+    }
+    if (route == LR_OTHER) {
+        out.code = 404;
+        out.contentType = "text/plain";
+        out.body = "Not found";
+        return;
+    }
+
+    ApiResponse response;
+    api.handle(route == LR_STATUS ? API_STATUS : route == LR_HISTORY ? API_HISTORY : API_SERIES,
+               query, ifNoneMatch, response);
+    out.code = response.code;
+    out.body = response.body;
+    memcpy(out.etag, response.etag, sizeof(out.etag));
+}
+
+// ============= Сокет shim (една нишка, като async_tcp) =============
+
+static HandlerStats handlerStats[LR_COUNT];
+// Клиентите спират първи, за да получат отговор на започнатите заявки
+static std::atomic<bool> clientsRunning(true);
+static std::atomic<bool> running(true);
+
+// Симулирано време (s) - 30 дни сесия преди старта на теста
+static const uint32_t START_TIME = 40 * 86400;
+
+static LoadRoute routeOf(const char* path, const char* query) {
+    if (strcmp(path, "/status/data") == 0) return LR_STATUS;
+    if (strcmp(path, "/history/data") == 0) return LR_HISTORY;
+    if (strcmp(path, "/metrics") == 0) return LR_METRICS;
+    if (strcmp(path, "/series") == 0) {
+        return query && strstr(query, "src=records") ? LR_SERIES_RECORDS : LR_SERIES_SAMPLES;
+    }
+    return LR_OTHER;
+}
+
+static void sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        data += n;
+        length -= n;
+    }
+}
+
+static void serveRequest(int fd, char* request) {
+    // "GET /path?query HTTP/1.1"
+    char* path = strchr(request, ' ');
+    if (!path) return;
+    path++;
+    char* end = strchr(path, ' ');
+    if (!end) return;
+    *end = '\0';
+    char* query = strchr(path, '?');
+    if (query) *query++ = '\0';
+
+    const char* ifNoneMatch = "";
+    char* header = strcasestr(end + 1, "\r\nIf-None-Match:");
+    if (header) {
+        header += 16;
+        while (*header == ' ') header++;
+        char* eol = strstr(header, "\r\n");
+        if (eol) *eol = '\0';
+        ifNoneMatch = header;
+    }
+
+    LoadRoute route = routeOf(path, query);
+    Response response;
+
+    allocationCount = 0;
+    countAllocations = true;
+    Clock::time_point start = Clock::now();
+    handle(route, query ? query : "", ifNoneMatch, response);
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    countAllocations = false;
+
+    size_t bodyLength = strlen(response.body);
+    HandlerStats& stats = handlerStats[route];
+    stats.requests++;
+    stats.handlerNs += ns;
+    stats.allocations += allocationCount;
+    stats.bodyBytes += bodyLength;
+    stats.codes[response.code == 200 ? 0 : response.code == 304 ? 1 : response.code < 500 ? 2 : 3]++;
+
+    // Като handleTimed() - броячите на /metrics
+    HttpRoute metricsRoute = route == LR_STATUS ? ROUTE_STATUS_DATA
+                           : route == LR_HISTORY ? ROUTE_HISTORY_DATA
+                           : route == LR_METRICS ? ROUTE_METRICS : ROUTE_SERIES;
+    metrics.httpRequests[metricsRoute].inc();
+    metrics.httpLatencyUs[metricsRoute].observe(ns / 1000);
+    if (response.code == 200) metrics.jsonBytes.inc(bodyLength);
+
+    char head[256];
+    int headLength = snprintf(head, sizeof(head),
+        "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s%s%sConnection: close\r\n\r\n",
+        response.code, response.code == 200 ? "OK" : response.code == 304 ? "Not Modified" : "Error",
+        response.contentType, bodyLength,
+        response.etag[0] ? "ETag: " : "", response.etag, response.etag[0] ? "\r\n" : "");
+    sendAll(fd, head, headLength);
+    sendAll(fd, response.body, bodyLength);
+}
+
+struct Connection {
+    int fd;
+    size_t length;
+    char buffer[1024];
+};
+
+static void serverThread(int listenFd) {
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds;
+    connections.reserve(256);
+
+    while (running.load()) {
+        fds.clear();
+        fds.push_back({ listenFd, POLLIN, 0 });
+        for (const Connection& c : connections) fds.push_back({ c.fd, POLLIN, 0 });
+
+        if (poll(fds.data(), fds.size(), 50) <= 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd >= 0) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                connections.push_back({ fd, 0, {} });
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Connection& c = connections[i - 1];
+            ssize_t n = recv(c.fd, c.buffer + c.length, sizeof(c.buffer) - 1 - c.length, 0);
+            bool done = n <= 0;
+            if (n > 0) {
+                c.length += n;
+                c.buffer[c.length] = '\0';
+                if (strstr(c.buffer, "\r\n\r\n")) {
+                    serveRequest(c.fd, c.buffer);
+                    done = true;
+                } else if (c.length >= sizeof(c.buffer) - 1) {
+                    done = true;
+                }
+            }
+            if (done) {
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const Connection& c) { return c.fd < 0; }),
+                          connections.end());
+    }
+    for (const Connection& c : connections) close(c.fd);
+}
+
+// ============= "loop()" =============
+
+static std::vector<uint32_t> samplerJitterUs;
+
+static void samplerThread() {
+    const auto interval = std::chrono::milliseconds(500);
+    uint32_t timestamp = START_TIME;
+    float weight = 3800.0f;
+    Clock::time_point next = Clock::now() + interval;
+    Clock::time_point last = Clock::now();
+
+    while (running.load()) {
+        std::this_thread::sleep_until(next);
+        Clock::time_point now = Clock::now();
+        int64_t actualUs = std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+        samplerJitterUs.push_back((uint32_t)std::llabs(actualUs - 500000));
+        last = now;
+        next += interval;
+
+        // Симулираното време тече по-бързо, за да има нови минути (записи в лога)
+        timestamp += 30;
+        weight += (rand() % 41 - 20) / 10.0f;
+        sampleLog.addReading(timestamp, weight);
+        publishWeight(weight);
+    }
+}
+
+// ============= Клиенти =============
+
+struct ClientStats {
+    std::vector<uint32_t> latencyUs[LR_COUNT];
+    uint32_t failures;
+};
+
+// Една заявка с Connection: close. Връща HTTP кода или -1.
+static int fetch(uint16_t port, const char* target, char* etag, size_t etagSize) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    char request[256];
+    int length = snprintf(request, sizeof(request),
+        "GET %s HTTP/1.1\r\nHost: scale.local\r\n%s%s%sConnection: close\r\n\r\n",
+        target, etag[0] ? "If-None-Match: " : "", etag, etag[0] ? "\r\n" : "");
+    sendAll(fd, request, length);
+
+    // Тялото се изчита и изхвърля; от заглавката трябват кодът и ETag-ът
+    static thread_local char response[16384];
+    size_t total = 0;
+    ssize_t n;
+    while ((n = recv(fd, response + total, sizeof(response) - 1 - total, 0)) > 0) {
+        total += n;
+        if (total >= sizeof(response) - 1) total = 0;
+    }
+    close(fd);
+    response[total] = '\0';
+
+    int code = -1;
+    if (sscanf(response, "HTTP/1.1 %d", &code) != 1) return -1;
+
+    const char* tag = strstr(response, "\r\nETag: ");
+    if (tag && code == 200) {
+        tag += 8;
+        size_t n = strcspn(tag, "\r");
+        if (n < etagSize) {
+            memcpy(etag, tag, n);
+            etag[n] = '\0';
+        }
+    }
+    return code;
+}
+
+static void clientThread(uint16_t port, bool historyPage, int intervalMs, ClientStats& stats) {
+    char etags[LR_COUNT][24] = {};
+
+    for (uint32_t tick = 0; clientsRunning.load(); tick++) {
+        struct { LoadRoute route; const char* target; } plan[2];
+        int count = 0;
+
+        if (historyPage) {
+            plan[count++] = { LR_HISTORY, "/history/data" };
+            if (tick % 30 == 0) plan[count++] = { LR_SERIES_RECORDS, "/series?src=records" };
+        } else {
+            plan[count++] = { LR_STATUS, "/status/data" };
+            if (tick % 60 == 0) plan[count++] = { LR_SERIES_SAMPLES, "/series?src=samples&points=200" };
+        }
+
+        for (int i = 0; i < count && clientsRunning.load(); i++) {
+            Clock::time_point start = Clock::now();
+            int code = fetch(port, plan[i].target, etags[plan[i].route], sizeof(etags[0]));
+            uint32_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            if (code < 0) {
+                stats.failures++;
+            } else {
+                stats.latencyUs[plan[i].route].push_back(us);
+            }
+        }
+
+        if (intervalMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+    }
+}
+
+// ============= Отчет =============
+
+static uint32_t percentile(std::vector<uint32_t>& values, double p) {
+    if (values.empty()) return 0;
+    size_t index = (size_t)(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void pinToCpu0() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(0, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+int main(int argc, char** argv) {
+    int clients = 8;
+    int seconds = 10;
+    int intervalMs = 0;
+    bool oneCore = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) clients = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) intervalMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--one-core") == 0) oneCore = true;
+        else {
+            fprintf(stderr, "usage: %s [-c clients] [-d seconds] [-i interval_ms] [--one-core]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (clients < 1) clients = 1;
+
+    // Наследява се от всички нишки
+    if (oneCore) pinToCpu0();
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addrLength = sizeof(addr);
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 512) < 0 ||
+        getsockname(listenFd, (sockaddr*)&addr, &addrLength) < 0) {
+        perror("listen");
+        return 1;
+    }
+    uint16_t port = ntohs(addr.sin_port);
+
+    api.begin(0x5ca1e000, &sampleLog, nullptr, nullptr);
+    fillState(START_TIME);
+    publishWeight(3800.0f);
+    samplerJitterUs.reserve(seconds * 4 + 16);
+
+    std::thread server(serverThread, listenFd);
+    std::thread sampler(samplerThread);
+
+    std::vector<ClientStats> stats(clients);
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < clients; i++) {
+        // Всеки четвърти клиент е на страницата с историята
+        threads.emplace_back(clientThread, port, i % 4 == 3, intervalMs, std::ref(stats[i]));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    clientsRunning.store(false);
+    for (std::thread& t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    running.store(false);
+    sampler.join();
+    server.join();
+    close(listenFd);
+
+    printf("%d clients, %d s, interval %d ms%s\n\n", clients, seconds, intervalMs, oneCore ? ", one core" : "");
+    printf("%-16s %8s %7s %7s %5s %5s %8s %8s %9s %8s %8s\n",
+           "route", "reqs", "200", "304", "4xx", "5xx", "p50 us", "p99 us", "handler", "allocs", "bytes");
+
+    std::vector<uint32_t> all;
+    uint32_t total = 0;
+    uint32_t failures = 0;
+    for (const ClientStats& s : stats) failures += s.failures;
+
+    for (uint8_t r = 0; r < LR_COUNT; r++) {
+        std::vector<uint32_t> latencies;
+        for (ClientStats& s : stats) {
+            latencies.insert(latencies.end(), s.latencyUs[r].begin(), s.latencyUs[r].end());
+        }
+        const HandlerStats& h = handlerStats[r];
+        if (latencies.empty() && h.requests == 0) continue;
+
+        all.insert(all.end(), latencies.begin(), latencies.end());
+        total += latencies.size();
+        uint32_t requests = h.requests ? h.requests : 1;
+        printf("%-16s %8zu %7u %7u %5u %5u %8u %8u %7.1fus %8.2f %8.0f\n",
+               LOAD_ROUTE_NAMES[r], latencies.size(), h.codes[0], h.codes[1], h.codes[2], h.codes[3],
+               percentile(latencies, 0.50), percentile(latencies, 0.99),
+               h.handlerNs / 1000.0 / requests, (double)h.allocations / requests,
+               (double)h.bodyBytes / requests);
+    }
+
+    printf("\ntotal %u requests, %.0f req/s, p50 %u us, p99 %u us, %u failed\n",
+           total, total / elapsed, percentile(all, 0.50), percentile(all, 0.99), failures);
+
+    uint32_t samplesTaken = samplerJitterUs.size();
+    printf("sampler: %u samples, jitter p50 %u us, p99 %u us, max %u us\n",
+           samplesTaken, percentile(samplerJitterUs, 0.50), percentile(samplerJitterUs, 0.99),
+           samplesTaken ? *std::max_element(samplerJitterUs.begin(), samplerJitterUs.end()) : 0);
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Host benchmark за JSON отговорите на web API-то.
+//
+// Мери ns на отговор и брой heap алокации на отговор за /status/data и
+// /history/data (1, 60 записа), с JsonWriter и със String-подобно
+// конкатениране (както беше преди), за сравнение. Двата начина дават един и
+// същ JSON - проверява се преди мерението, при разлика изход 1.
+//
+// Build & run (Linux, от корена на проекта):
+//   g++ -O2 -std=c++17 -Iinclude bench/json_bench.cpp src/JsonWriter.cpp src/WebApi.cpp src/Downsampler.cpp -o json_bench
+//   ./json_bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "JsonWriter.h"
+#include "WebApi.h"
+
+// ============= Брояч на алокации =============
+
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* p = malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ============= Данни =============
+
+static DailyRecord records[MAX_DAILY_RECORDS];
+static const uint32_t SESSION_START = 1700000000;
+
+static void fillRecords() {
+    float weight = 5000.0f;
+    for (int i = 0; i < MAX_DAILY_RECORDS; i++) {
+        float change = weight * 0.012f;
+        weight -= change;
+        records[i].day = i + 1;
+        records[i].timestamp = SESSION_START + i * 86400;
+        records[i].weight = weight;
+        records[i].lossPercent = (5000.0f - weight) / 5000.0f * 100.0f;
+        records[i].dayChange = change;
+    }
+}
+
+static StatusSnapshot makeStatus() {
+    StatusSnapshot snap;
+    snap.active = true;
+    snap.initialWeight = 5000.0f;
+    snap.currentWeight = 3712.4f;
+    snap.targetLoss = 40.0f;
+    snap.currentDay = 23;
+    snap.recordCount = 23;
+    snap.daysRemaining = 14;
+    snap.isReady = false;
+    return snap;
+}
+
+// ============= Старият начин (String + String(float, 1)) =============
+
+static std::string fmt(float v) {
+    char tmp[16];
+    snprintf(tmp, sizeof(tmp), "%.1f", v);
+    return std::string(tmp);
+}
+
+static std::string legacyStatus(const StatusSnapshot& s) {
+    std::string json = "{";
+    json += "\"active\":" + std::string(s.active ? "true" : "false") + ",";
+    json += "\"initialWeight\":" + fmt(s.initialWeight) + ",";
+    json += "\"currentWeight\":" + fmt(s.currentWeight) + ",";
+    json += "\"targetLoss\":" + fmt(s.targetLoss) + ",";
+    json += "\"currentLoss\":" + fmt(realtimeLossPercent(s.initialWeight, s.currentWeight)) + ",";
+    json += "\"currentDay\":" + std::to_string(s.currentDay) + ",";
+    json += "\"recordCount\":" + std::to_string(s.recordCount) + ",";
+    json += "\"daysRemaining\":" + std::to_string(s.daysRemaining) + ",";
+    json += "\"isReady\":" + std::string(s.isReady ? "true" : "false");
+    json += "}";
+    return json;
+}
+
+// Същите полета като writeHistoryJson (текуща сесия, без филтри), за да е
+// сравнението на еднакъв отговор
+static std::string legacyHistory(int count) {
+    std::string json = "{";
+    json += "\"active\":true,";
+    json += "\"archive\":0,";
+    json += "\"sessionStart\":" + std::to_string(SESSION_START) + ",";
+    json += "\"total\":" + std::to_string(count) + ",";
+    json += "\"start\":0,";
+    json += "\"next\":" + std::to_string(count) + ",";
+    json += "\"records\":[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += "{";
+        json += "\"day\":" + std::to_string(records[i].day) + ",";
+        json += "\"weight\":" + fmt(records[i].weight) + ",";
+        json += "\"loss\":" + fmt(records[i].lossPercent) + ",";
+        json += "\"change\":" + fmt(records[i].dayChange);
+        json += "}";
+    }
+    json += "]}";
+    return json;
+}
+
+// ============= Измерване =============
+
+static volatile size_t sink = 0;
+
+template <typename F>
+static void run(const char* name, F fn) {
+    const int warmup = 1000;
+    const int iterations = 200000;
+
+    for (int i = 0; i < warmup; i++) sink += fn();
+
+    size_t allocsBefore = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (int i = 0; i < iterations; i++) bytes = fn();
+    auto end = std::chrono::steady_clock::now();
+    size_t allocs = allocationCount - allocsBefore;
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    printf("%-28s %8.1f ns/resp %8.2f allocs/resp %6zu bytes\n",
+           name, ns, (double)allocs / iterations, bytes);
+    sink += bytes;
+}
+
+// Двата начина трябва да дават един и същ JSON, иначе времената не са сравними
+static bool sameOutput(const char* name, const char* current, const std::string& legacy) {
+    if (legacy == current) {
+        return true;
+    }
+    fprintf(stderr, "%s: outputs differ\n  JsonWriter: %s\n  legacy:     %s\n", name, current, legacy.c_str());
+    return false;
+}
+
+int main() {
+    fillRecords();
+    StatusSnapshot status = makeStatus();
+    static char buffer[64 + MAX_DAILY_RECORDS * 64];
+
+    bool same = true;
+    {
+        JsonWriter json(buffer, sizeof(buffer));
+        writeStatusJson(json, status);
+        same = sameOutput("status", buffer, legacyStatus(status)) && same;
+    }
+    for (int count : { 1, (int)MAX_DAILY_RECORDS }) {
+        JsonWriter json(buffer, sizeof(buffer));
+        writeHistoryJson(json, true, 0, SESSION_START, records, count, true, HistoryQuery());
+        same = sameOutput("history", buffer, legacyHistory(count)) && same;
+    }
+    if (!same) {
+        return 1;
+    }
+
+    printf("%-28s %16s %20s %12s\n", "response", "time", "heap", "size");
+
+    run("status  JsonWriter", [&]() {
+        JsonWriter json(buffer, sizeof(buffer));
+        writeStatusJson(json, status);
+        return json.length();
+    });
+    run("status  String concat", [&]() {
+        return legacyStatus(status).size();
+    });
+
+    const int sizes[] = { 1, MAX_DAILY_RECORDS };
+    for (int count : sizes) {
+        char name[64];
+
+        snprintf(name, sizeof(name), "history %2d JsonWriter", count);
+        run(name, [&]() {
+            JsonWriter json(buffer, sizeof(buffer));
+            writeHistoryJson(json, true, 0, SESSION_START, records, count, true, HistoryQuery());
+            return json.length();
+        });
+
+        snprintf(name, sizeof(name), "history %2d String concat", count);
+        run(name, [&]() {
+            return legacyHistory(count).size();
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+// Микробенчмарк на горещите пътища (MicroBench) на Linux и сравнение
+// на резултати.
+//
+// Пуска същите случаи като serial "bench" на устройството - обработка на
+// проба, convertWeight, JSON на web API-то, saveSession/loadSession (LittleFS
+// в паметта) и съставяне на OLED кадър при 1, 60 и 1000 записа/проби - върху
+// истинските модули с HAL-а от hal/native/. На host "цикъл" = ns.
+//
+// Сравнението чете два JSON-а от MicroBench::printJson (native или изхода
+// на устройството, копиран от serial монитора) и показва промяната на
+// best_ns по случай. Код 1, ако някой случай е по-бавен от прага.
+//
+// Build & run (Linux, от корена на проекта) - програмата на env:native_bench:
+//   pio run -e native_bench && .pio/build/native_bench/program [опции]
+// или без PlatformIO (ArduinoJson 6 от .pio/libdeps/native или друго копие):
+//   g++ -O2 -std=gnu++17 -Ihal/native -Iinclude -I<ArduinoJson>/src bench/microbench.cpp hal/native/*.cpp
+//       $(ls src/*.cpp | grep -v -e main.cpp -e WebServer -e WebAssets) -o microbench
+//
+// Опции:
+//   -o <файл>              резултатът в JSON файл (иначе на stdout)
+//   -c <база.json>         сравнение на текущото пускане с базата
+//   -c <база.json> <нов>   сравнение на два файла без пускане
+//   -t <%>                 праг за забавяне при сравнение (10)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "MicroBench.h"
+
+static ScaleManager scale(18, 19);
+static StorageManager storage;
+static DisplayManager display;
+static MicroBench bench(scale, storage, display);
+
+// Print към FILE* за printJson()
+class FilePrint : public Print {
+public:
+    explicit FilePrint(FILE* file) : file(file) {}
+    size_t write(uint8_t c) override { return fputc(c, file) == EOF ? 0 : 1; }
+
+private:
+    FILE* file;
+};
+
+// ============= Сравнение =============
+
+#define MAX_CASES MICROBENCH_MAX_RESULTS
+
+struct CaseTime {
+    char name[32];
+    unsigned size;
+    double ns;
+};
+
+struct BenchFile {
+    char target[32];
+    CaseTime cases[MAX_CASES];
+    int count;
+};
+
+// Форматът е ред на случай (MicroBench::printJson), затова без JSON парсер
+static bool readBenchFile(const char* path, BenchFile& out) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "microbench: cannot open %s\n", path);
+        return false;
+    }
+
+    out.count = 0;
+    strcpy(out.target, "?");
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        const char* target = strstr(line, "{\"target\":\"");
+        if (target) {
+            sscanf(target, "{\"target\":\"%31[^\"]\"", out.target);
+            continue;
+        }
+        const char* item = strstr(line, "{\"case\":\"");
+        if (!item || out.count >= MAX_CASES) {
+            continue;
+        }
+        CaseTime& c = out.cases[out.count];
+        unsigned iterations;
+        unsigned best;
+        unsigned mean;
+        if (sscanf(item, "{\"case\":\"%31[^\"]\",\"n\":%u,\"iterations\":%u,\"best_cycles\":%u,"
+                         "\"mean_cycles\":%u,\"best_ns\":%lf",
+                   c.name, &c.size, &iterations, &best, &mean, &c.ns) == 6) {
+            out.count++;
+        }
+    }
+    fclose(file);
+
+    if (out.count == 0) {
+        fprintf(stderr, "microbench: no results in %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static int compare(const BenchFile& base, const BenchFile& current, double thresholdPercent) {
+    if (strcmp(base.target, current.target) != 0) {
+        printf("note: comparing %s against %s\n", current.target, base.target);
+    }
+    printf("%-16s %6s %14s %14s %9s\n", "case", "n", "base ns", "now ns", "change");
+
+    int regressions = 0;
+    for (int i = 0; i < current.count; i++) {
+        const CaseTime& now = current.cases[i];
+        const CaseTime* before = nullptr;
+        for (int j = 0; j < base.count; j++) {
+            if (strcmp(base.cases[j].name, now.name) == 0 && base.cases[j].size == now.size) {
+                before = &base.cases[j];
+                break;
+            }
+        }
+        if (!before || before->ns <= 0) {
+            printf("%-16s %6u %14s %14.1f %9s\n", now.name, now.size, "-", now.ns, "new");
+            continue;
+        }
+
+        double change = (now.ns - before->ns) / before->ns * 100.0;
+        bool slower = change > thresholdPercent;
+        if (slower) regressions++;
+        printf("%-16s %6u %14.1f %14.1f %+8.1f%%%s\n", now.name, now.size, before->ns, now.ns,
+               change, slower ? "  SLOWER" : "");
+    }
+
+    printf("%d regression(s) over %.0f%%\n", regressions, thresholdPercent);
+    return regressions > 0 ? 1 : 0;
+}
+
+// ============= main =============
+
+int main(int argc, char** argv) {
+    const char* outputPath = nullptr;
+    const char* basePath = nullptr;
+    double thresholdPercent = 10.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:c:t:")) != -1) {
+        switch (opt) {
+            case 'o': outputPath = optarg; break;
+            case 'c': basePath = optarg; break;
+            case 't': thresholdPercent = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: microbench [-o out.json] [-c base.json [current.json]] [-t percent]\n");
+                return 2;
+        }
+    }
+
+    // Два файла - само сравнение
+    BenchFile base;
+    if (basePath && !readBenchFile(basePath, base)) {
+        return 2;
+    }
+    if (basePath && optind < argc) {
+        BenchFile current;
+        if (!readBenchFile(argv[optind], current)) {
+            return 2;
+        }
+        return compare(base, current, thresholdPercent);
+    }
+
+    hostSerialQuiet = true;
+    display.begin();
+    scale.begin();
+    storage.begin();
+    bench.run();
+    hostSerialQuiet = false;
+
+    FILE* output = stdout;
+    if (outputPath) {
+        output = fopen(outputPath, "w");
+        if (!output) {
+            fprintf(stderr, "microbench: cannot write %s\n", outputPath);
+            return 2;
+        }
+    }
+    FilePrint out(output);
+    bench.printJson(out);
+    if (output != stdout) fclose(output);
+
+    if (!basePath) {
+        return 0;
+    }
+
+    // Сравнение на току-що измереното
+    BenchFile current;
+    strcpy(current.target, ESP.getChipModel());
+    current.count = 0;
+    for (uint8_t i = 0; i < bench.getResultCount() && current.count < MAX_CASES; i++) {
+        const BenchResult& r = bench.getResult(i);
+        CaseTime& c = current.cases[current.count++];
+        snprintf(c.name, sizeof(c.name), "%s", r.name);
+        c.size = r.size;
+        c.ns = r.bestCycles * 1000.0 / ESP.getCpuFreqMHz();
+    }
+    if (output == stdout) printf("\n");
+    return compare(base, current, thresholdPercent);
+}
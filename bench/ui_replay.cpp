@@ -0,0 +1,346 @@
+// Host replay на UI сценарии срещу истинските ButtonHandler, UiController,
+// DisplayManager и DryingSessionManager (hal/native/ заменя Arduino API-то,
+// OLED-ът е буфер в паметта, файловете и NVS също). Времето е виртуално, така че 60-дневна
+// сесия минава за милисекунди.
+//
+// Сценарият е текст, по едно действие на ред: "<време> <команда> [аргументи]".
+//   Време: абсолютно в ms ("12500") или спрямо предишното действие
+//          ("+500", "+3s", "+10m", "+2h", "+1d").
+//   weight <g>                  - какво показва кантарът
+//   down|up <TARE|UNIT|START>   - фронт на бутон (формата на serial "keys")
+//   click <бутон> [задържане]   - down и up след задържането (по подразбиране 100 ms)
+//   step <време>                - най-голямата стъпка на виртуалния loop()
+//                                 (по подразбиране 10 ms; "1h" за дълги периоди)
+//   expect op NORMAL|DRYING
+//   expect mode NORMAL|LIVE|STATS|HISTORY|GRAPH
+//   expect records <n>
+//   expect unit g|kg|oz|lb
+//   expect text <текст>         - текстът е някъде на екрана
+//   dump                        - екранът като текст и пиксели
+//   echo <текст>
+// Записан с "keys" лог от устройството е валиден сценарий (само фронтове).
+//
+// Build & run (Linux, от корена на проекта) - програмата на env:native:
+//   pio run -e native && .pio/build/native/program bench/scenarios/*.txt [-v]
+// или без PlatformIO (ArduinoJson 6 от .pio/libdeps/native или друго копие):
+//   g++ -O2 -std=gnu++17 -Ihal/native -Iinclude -I<ArduinoJson>/src bench/ui_replay.cpp hal/native/*.cpp
+//       $(ls src/*.cpp | grep -v -e main.cpp -e WebServer -e WebAssets) -o ui_replay
+//   ./ui_replay bench/scenarios/*.txt [-v]
+//
+// Връща 1, ако някое expect не е изпълнено.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ScaleManager.h"
+#include "StorageManager.h"
+#include "DryingSessionManager.h"
+#include "DisplayManager.h"
+#include "ButtonHandler.h"
+#include "UiController.h"
+#include "HX711.h"
+
+// Пиновете не се четат на host - важат само индексите на бутоните
+static ScaleManager scale(18, 19);
+static StorageManager storage;
+static DryingSessionManager drying(storage);
+static DisplayManager display;
+static ButtonHandler buttons(33, 25, 26);
+static UiController ui(display, buttons, drying, scale);
+
+static const uint32_t WEIGHT_READ_INTERVAL = 500;
+static const uint32_t LOOP_DELAY_MS = 10;
+
+static uint32_t stepMs = LOOP_DELAY_MS;
+static uint64_t lastWeightRead = 0;
+static float currentWeight = 0.0f;
+static uint64_t loopCount = 0;
+static int failures = 0;
+
+// ============= Виртуалният loop() =============
+
+// Същият ред като UI частите на loop() в main.cpp
+static void runLoopOnce() {
+    uint64_t now = hostTime();
+    if (now - lastWeightRead >= WEIGHT_READ_INTERVAL) {
+        float weight = scale.getRawWeight();
+        if (!isnan(weight)) {
+            currentWeight = weight;
+            ui.addSample(now / 1000, currentWeight);
+        }
+        lastWeightRead = now;
+    }
+
+    ui.update(currentWeight, false);
+
+    buttons.update(scale, drying, display);
+    ui.applyRequests(buttons.popUiRequests());
+    loopCount++;
+}
+
+static void runUntil(uint64_t target) {
+    while (hostTime() < target) {
+        uint64_t next = hostTime() + stepMs;
+        hostSetTime(next < target ? next : target);
+        runLoopOnce();
+    }
+}
+
+static void setup() {
+    display.begin();
+    scale.begin();
+    // 1 отчет = 1 g, за да задава сценарият директно грамове
+    scale.applyCalibration(0, 1.0f);
+    storage.begin();
+    drying.begin();
+    buttons.begin();
+    buttons.setMode(ButtonHandler::OP_MODE_NORMAL);
+    display.setMode(DisplayManager::MODE_NORMAL);
+    display.showNormalWeight(0.0f, scale.getUnit());
+    ui.forceRedraw();
+}
+
+// ============= Сценарий =============
+
+static bool parseDuration(const char* text, uint64_t& ms) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || value < 0) {
+        return false;
+    }
+    double scaleMs = 1;
+    if (strcmp(end, "s") == 0) scaleMs = 1000;
+    else if (strcmp(end, "m") == 0) scaleMs = 60000;
+    else if (strcmp(end, "h") == 0) scaleMs = 3600000;
+    else if (strcmp(end, "d") == 0) scaleMs = 86400000;
+    else if (*end != '\0' && strcmp(end, "ms") != 0) return false;
+    ms = (uint64_t)(value * scaleMs);
+    return true;
+}
+
+static int parseButton(const char* name) {
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        if (name && strcmp(name, ButtonHandler::buttonName(i)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static const char* modeName(DisplayManager::DisplayMode mode) {
+    switch (mode) {
+        case DisplayManager::MODE_NORMAL:         return "NORMAL";
+        case DisplayManager::MODE_DRYING_LIVE:    return "LIVE";
+        case DisplayManager::MODE_DRYING_STATS:   return "STATS";
+        case DisplayManager::MODE_DRYING_HISTORY: return "HISTORY";
+        case DisplayManager::MODE_DRYING_GRAPH:   return "GRAPH";
+    }
+    return "?";
+}
+
+static bool screenContains(const char* text) {
+    const Adafruit_SSD1306* oled = Adafruit_SSD1306::hostInstance;
+    for (uint8_t i = 0; i < oled->textLineCount(); i++) {
+        if (strstr(oled->textLine(i).text, text)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void dumpScreen() {
+    const Adafruit_SSD1306* oled = Adafruit_SSD1306::hostInstance;
+    printf("  -- t=%.3fs mode=%s --\n", hostTime() / 1000.0, modeName(display.getMode()));
+    for (uint8_t i = 0; i < oled->textLineCount(); i++) {
+        const Adafruit_GFX::TextLine& line = oled->textLine(i);
+        printf("  [%3d,%2d x%u] %s\n", line.x, line.y, line.size, line.text);
+    }
+    // Пикселите (графики, ленти) по два реда на символ
+    for (int16_t y = 0; y < SCREEN_HEIGHT; y += 2) {
+        char row[SCREEN_WIDTH + 1];
+        bool any = false;
+        for (int16_t x = 0; x < SCREEN_WIDTH; x++) {
+            bool top = oled->getPixel(x, y);
+            bool bottom = oled->getPixel(x, y + 1);
+            row[x] = top && bottom ? '#' : top ? '\'' : bottom ? '.' : ' ';
+            any = any || top || bottom;
+        }
+        row[SCREEN_WIDTH] = '\0';
+        if (any) printf("  |%s|\n", row);
+    }
+}
+
+static void fail(const char* file, int line, const char* message) {
+    printf("FAIL %s:%d: %s (t=%.3fs)\n", file, line, message, hostTime() / 1000.0);
+    failures++;
+}
+
+static void expect(const char* file, int lineNo, char* args) {
+    char* what = strtok(args, " \t");
+    char* value = strtok(nullptr, "");
+    while (value && (*value == ' ' || *value == '\t')) value++;
+    char message[160];
+
+    if (!what || !value) {
+        fail(file, lineNo, "expect needs <what> <value>");
+    } else if (strcmp(what, "op") == 0) {
+        const char* actual = buttons.getMode() == ButtonHandler::OP_MODE_NORMAL ? "NORMAL" : "DRYING";
+        if (strcmp(actual, value) != 0) {
+            snprintf(message, sizeof(message), "op is %s, expected %s", actual, value);
+            fail(file, lineNo, message);
+        }
+    } else if (strcmp(what, "mode") == 0) {
+        const char* actual = modeName(display.getMode());
+        if (strcmp(actual, value) != 0) {
+            snprintf(message, sizeof(message), "mode is %s, expected %s", actual, value);
+            fail(file, lineNo, message);
+        }
+    } else if (strcmp(what, "records") == 0) {
+        int actual = drying.getRecordCount();
+        if (actual != atoi(value)) {
+            snprintf(message, sizeof(message), "%d records, expected %s", actual, value);
+            fail(file, lineNo, message);
+        }
+    } else if (strcmp(what, "unit") == 0) {
+        const char* actual = unitFormat(scale.getUnit()).suffix;
+        if (strcmp(actual, value) != 0) {
+            snprintf(message, sizeof(message), "unit is %s, expected %s", actual, value);
+            fail(file, lineNo, message);
+        }
+    } else if (strcmp(what, "text") == 0) {
+        if (!screenContains(value)) {
+            snprintf(message, sizeof(message), "screen has no \"%s\"", value);
+            fail(file, lineNo, message);
+            dumpScreen();
+        }
+    } else {
+        snprintf(message, sizeof(message), "unknown expect \"%s\"", what);
+        fail(file, lineNo, message);
+    }
+}
+
+static bool runScenario(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("FAIL cannot open %s\n", path);
+        failures++;
+        return false;
+    }
+
+    char line[256];
+    int lineNo = 0;
+    uint64_t actionTime = hostTime();
+
+    while (fgets(line, sizeof(line), file)) {
+        lineNo++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        char* end = line + strlen(line);
+        while (end > line && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+
+        char* timeText = strtok(line, " \t");
+        if (!timeText) continue;
+        char* command = strtok(nullptr, " \t");
+        char* args = strtok(nullptr, "");
+        while (args && (*args == ' ' || *args == '\t')) args++;
+
+        uint64_t t;
+        bool relative = timeText[0] == '+';
+        if (!parseDuration(relative ? timeText + 1 : timeText, t) || !command) {
+            fail(path, lineNo, "expected \"<time> <command>\"");
+            continue;
+        }
+        actionTime = relative ? actionTime + t : t;
+        if (actionTime < hostTime()) {
+            actionTime = hostTime();
+        }
+        runUntil(actionTime);
+
+        if (strcmp(command, "weight") == 0 && args) {
+            HX711::hostRaw = atol(args);
+        } else if (strcmp(command, "down") == 0 || strcmp(command, "up") == 0) {
+            int button = parseButton(args);
+            if (button < 0) {
+                fail(path, lineNo, "unknown button");
+                continue;
+            }
+            buttons.injectEdge(button, command[0] == 'd', (uint32_t)hostTime());
+        } else if (strcmp(command, "click") == 0) {
+            char* name = args ? strtok(args, " \t") : nullptr;
+            char* holdText = strtok(nullptr, " \t");
+            int button = parseButton(name);
+            uint64_t hold = 100;
+            if (button < 0 || (holdText && !parseDuration(holdText, hold))) {
+                fail(path, lineNo, "click <button> [hold]");
+                continue;
+            }
+            buttons.injectEdge(button, true, (uint32_t)hostTime());
+            runUntil(hostTime() + hold);
+            buttons.injectEdge(button, false, (uint32_t)hostTime());
+            actionTime = hostTime();
+        } else if (strcmp(command, "step") == 0) {
+            uint64_t step;
+            if (!args || !parseDuration(args, step) || step == 0) {
+                fail(path, lineNo, "step <time>");
+                continue;
+            }
+            stepMs = (uint32_t)step;
+        } else if (strcmp(command, "expect") == 0 && args) {
+            // Натисканията се разпознават в следващия loop()
+            runLoopOnce();
+            expect(path, lineNo, args);
+        } else if (strcmp(command, "dump") == 0) {
+            dumpScreen();
+        } else if (strcmp(command, "echo") == 0) {
+            printf("  %s\n", args ? args : "");
+        } else {
+            fail(path, lineNo, "unknown command");
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    int scenarios = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) verbose = true;
+    }
+    hostSerialQuiet = !verbose;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') continue;
+
+        // Всеки сценарий започва от чисто устройство
+        int before = failures;
+        if (drying.isActive()) {
+            drying.endSession();
+        }
+        storage.format();
+        hostSetTime(hostTime() + 1000);
+        setup();
+        stepMs = LOOP_DELAY_MS;
+        loopCount = 0;
+        uint64_t startTime = hostTime();
+
+        auto start = std::chrono::steady_clock::now();
+        runScenario(argv[i]);
+        auto end = std::chrono::steady_clock::now();
+
+        double wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+        printf("%s %s: %.1f h simulated in %.1f ms (%llu loops)\n",
+               failures == before ? "OK  " : "FAIL", argv[i],
+               (hostTime() - startTime) / 3600000.0, wallMs, (unsigned long long)loopCount);
+        scenarios++;
+    }
+
+    if (scenarios == 0) {
+        printf("usage: %s scenario.txt... [-v]\n", argv[0]);
+        return 2;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// Рисуването е истинско (в буфера на дисплея), текстът се пази като
+// редове с позиция - достатъчно за проверките в сценариите
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+    }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+    }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, y + h - 1, w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(x + w - 1, y, h, color);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < w; i++) drawFastVLine(x + i, y, h, color);
+    }
+
+    void setTextSize(uint8_t size) { textSize = size ? size : 1; }
+    void setTextColor(uint16_t) {}
+    void setTextWrap(bool) {}
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; startLine(); }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+    int16_t width() const { return WIDTH; }
+    int16_t height() const { return HEIGHT; }
+
+    size_t write(uint8_t c) override {
+        if (c == '\n') {
+            cursorX = 0;
+            cursorY += 8 * textSize;
+            startLine();
+        } else if (c != '\r') {
+            TextLine& line = lines[lineCount - 1];
+            if (line.length < sizeof(line.text) - 1) {
+                line.text[line.length++] = (char)c;
+                line.text[line.length] = '\0';
+            }
+            cursorX += 6 * textSize;
+        }
+        return 1;
+    }
+
+    // Текстът на екрана от последното clearDisplay(), ред по ред. Без heap
+    // като истинската библиотека - bench/display_alloc брои алокациите.
+    struct TextLine {
+        int16_t x;
+        int16_t y;
+        uint8_t size;
+        uint8_t length;
+        char text[32];          // Редът е до 21 знака при размер 1
+    };
+    static const uint8_t MAX_LINES = 24;
+    uint8_t textLineCount() const { return lineCount; }
+    const TextLine& textLine(uint8_t i) const { return lines[i]; }
+
+protected:
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+
+    void clearText() { lineCount = 0; startLine(); }
+
+private:
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    uint8_t textSize = 1;
+    TextLine lines[MAX_LINES];
+    uint8_t lineCount = 0;
+
+    void startLine() {
+        if (lineCount > 0 && lines[lineCount - 1].length == 0) {
+            lineCount--;
+        }
+        if (lineCount < MAX_LINES) {
+            lineCount++;
+        }
+        TextLine& line = lines[lineCount - 1];
+        line.x = cursorX;
+        line.y = cursorY;
+        line.size = textSize;
+        line.length = 0;
+        line.text[0] = '\0';
+    }
+};
+
+#endif
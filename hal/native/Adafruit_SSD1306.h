@@ -0,0 +1,47 @@
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Adafruit_GFX.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_PAGEADDR   0x22
+#define SSD1306_COLUMNADDR 0x21
+
+// Буфер в паметта със същата подредба като на панела (страници по 8 реда)
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire*, int8_t, uint32_t = 400000, uint32_t = 100000)
+        : Adafruit_GFX(w, h) {
+        memset(buffer, 0, sizeof(buffer));
+        hostInstance = this;
+    }
+
+    // Последно създаденият дисплей (DisplayManager го държи private)
+    static Adafruit_SSD1306* hostInstance;
+
+    bool begin(uint8_t = SSD1306_SWITCHCAPVCC, uint8_t = 0x3C) { return true; }
+    void display() {}
+    void clearDisplay() { memset(buffer, 0, sizeof(buffer)); clearText(); }
+    uint8_t* getBuffer() { return buffer; }
+    void ssd1306_command(uint8_t) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+        uint8_t& cell = buffer[x + (y / 8) * WIDTH];
+        if (color) cell |= (1 << (y & 7));
+        else cell &= ~(1 << (y & 7));
+    }
+    bool getPixel(int16_t x, int16_t y) const {
+        if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return false;
+        return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+    }
+
+private:
+    uint8_t buffer[128 * 64 / 8];
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// HAL за native build (env:native): Arduino/FreeRTOS API-то върху Linux.
+// Времето е виртуално - движи го програмата (delay(), hostSetTime()),
+// GPIO са масив от нива, задачите не се пускат (всичко е в една нишка).
+// Останалите заместители: HX711.h (източник на отчети), Adafruit_SSD1306.h
+// (кадър в паметта), LittleFS.h (файлове в паметта), Preferences.h,
+// WiFi.h / HTTPClient.h (мрежа, която се включва и изключва от теста).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <string>
+
+using std::abs;
+using std::isnan;
+
+#define LOW  0
+#define HIGH 1
+#define INPUT        0x01
+#define INPUT_PULLUP 0x05
+#define OUTPUT       0x03
+#define CHANGE  3
+#define FALLING 2
+#define RISING  1
+#define IRAM_ATTR
+
+// ============= Време =============
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);        // Мести виртуалното време
+void hostSetTime(uint64_t ms);
+uint64_t hostTime();
+
+// ============= GPIO =============
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+// Ниво на вход отвън (бутон); вика прекъсването, ако фронтът съвпада
+void hostSetPin(uint8_t pin, int level);
+int hostGetPin(uint8_t pin);        // Последното digitalWrite (зумер)
+
+uint32_t esp_random();
+
+// ESP: брояч на цикли за MicroBench - реалното време (steady_clock) при
+// условна честота 1000 MHz, т.е. цикъл = ns. Не зависи от виртуалния часовник.
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 1000; }
+    const char* getChipModel() { return "native"; }
+};
+
+extern EspClass ESP;
+
+// ============= Текст =============
+
+class String {
+public:
+    String(const char* s = "") : value(s ? s : "") {}
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.size(); }
+    bool operator==(const char* s) const { return value == s; }
+private:
+    std::string value;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (n < size && write(buffer[n])) n++;
+        return n;
+    }
+    size_t write(const char* s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { char b[12]; snprintf(b, sizeof(b), "%d", v); return write(b); }
+    size_t println() { return write((uint8_t)'\n'); }
+    size_t println(const char* s) { return print(s) + println(); }
+    size_t println(const String& s) { return print(s) + println(); }
+    size_t println(int v) { return print(v) + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    size_t readBytes(char* buffer, size_t length) {
+        size_t n = 0;
+        int c;
+        while (n < length && (c = read()) >= 0) buffer[n++] = (char)c;
+        return n;
+    }
+};
+
+// Serial -> stdout; hostSerialQuiet спира лога на фърмуера
+class HostSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    int available() { return 0; }
+};
+
+extern HostSerial Serial;
+extern bool hostSerialQuiet;
+
+// ============= FreeRTOS =============
+
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void* QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef struct { int locked; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY 0xFFFFFFFFu
+
+// Задачите не се пускат - runner-ът е еднонишков като loop()
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack,
+                                   void* arg, int priority, TaskHandle_t* handle, int core);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+const char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+
+// Опашка без чакане - празна/пълна връща веднага pdFALSE
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+// Една нишка - mutex-ът винаги е свободен
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#endif
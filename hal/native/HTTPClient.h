@@ -0,0 +1,29 @@
+#ifndef HOST_HTTPCLIENT_H
+#define HOST_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// HTTP клиент без мрежа: POST успява (hostResponseCode), ако WiFi е
+// свързан; последната заявка остава за проверка от теста
+class HTTPClient {
+public:
+    void setTimeout(uint16_t) {}
+    void setConnectTimeout(int32_t) {}
+    bool begin(const char* url);
+    void addHeader(const char*, const char*) {}
+    int POST(uint8_t* payload, size_t size);
+    void end() {}
+
+    static int hostResponseCode;
+    static uint32_t hostPostCount;
+    static std::string hostLastUrl;
+    static std::string hostLastBody;
+
+private:
+    std::string url;
+};
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef HOST_HX711_H
+#define HOST_HX711_H
+
+#include <Arduino.h>
+
+// Тензодатчикът връща hostRaw (задава се от сценария, "weight") или,
+// ако е зададен hostSource, отчета на модела за текущото виртуално време
+class HX711 {
+public:
+    static long hostRaw;
+    static long (*hostSource)(uint64_t timeMs);
+
+    void begin(uint8_t, uint8_t) {}
+    bool is_ready() { return true; }
+    long read() { return hostSource ? hostSource(hostTime()) : hostRaw; }
+    void set_scale(float value) { scale = value; }
+    void set_offset(long value) { offset = value; }
+    long get_offset() { return offset; }
+    float get_units(uint8_t) { return (read() - offset) / scale; }
+    void tare(uint8_t = 10) { offset = read(); }
+
+private:
+    float scale = 1.0f;
+    long offset = 0;
+};
+
+#endif
@@ -0,0 +1,167 @@
+// Реализация на native HAL-а (hal/native/*.h): време, GPIO, Serial, FreeRTOS
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <esp_timer.h>
+#include <stdarg.h>
+#include <chrono>
+#include <vector>
+#include "Adafruit_SSD1306.h"
+#include "HX711.h"
+
+static uint64_t nowMs = 0;
+
+uint32_t millis() { return (uint32_t)nowMs; }
+uint32_t micros() { return (uint32_t)(nowMs * 1000); }
+void delay(uint32_t ms) { nowMs += ms; }
+void hostSetTime(uint64_t ms) { if (ms > nowMs) nowMs = ms; }
+uint64_t hostTime() { return nowMs; }
+int64_t esp_timer_get_time() { return (int64_t)nowMs * 1000; }
+
+// ============= GPIO =============
+
+#define HOST_PIN_COUNT 40
+
+struct HostPin {
+    int level = HIGH;           // Бутоните са с pull-up: отпуснат = HIGH
+    void (*handler)(void*) = nullptr;
+    void* arg = nullptr;
+    int mode = 0;
+};
+static HostPin pins[HOST_PIN_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < HOST_PIN_COUNT && mode == OUTPUT) pins[pin].level = LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? pins[pin].level : HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < HOST_PIN_COUNT) pins[pin].level = value ? HIGH : LOW;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin >= HOST_PIN_COUNT) return;
+    pins[pin].handler = handler;
+    pins[pin].arg = arg;
+    pins[pin].mode = mode;
+}
+
+void hostSetPin(uint8_t pin, int level) {
+    if (pin >= HOST_PIN_COUNT) return;
+    HostPin& p = pins[pin];
+    int previous = p.level;
+    p.level = level ? HIGH : LOW;
+    if (!p.handler || previous == p.level) return;
+    if (p.mode == CHANGE || (p.mode == RISING && p.level == HIGH) ||
+        (p.mode == FALLING && p.level == LOW)) {
+        p.handler(p.arg);
+    }
+}
+
+int hostGetPin(uint8_t pin) {
+    return digitalRead(pin);
+}
+
+// Повторяема последователност - еднакви резултати при всяко пускане
+uint32_t esp_random() {
+    static uint32_t state = 0x12345678;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+HostSerial Serial;
+bool hostSerialQuiet = false;
+
+size_t HostSerial::write(uint8_t c) {
+    if (!hostSerialQuiet) putchar(c);
+    return 1;
+}
+
+size_t HostSerial::printf(const char* format, ...) {
+    if (hostSerialQuiet) return 0;
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n > 0 ? n : 0;
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, int,
+                                   TaskHandle_t* handle, int) {
+    if (handle) *handle = nullptr;
+    return pdPASS;
+}
+void xTaskNotifyGive(TaskHandle_t) {}
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+    *previousWake += period;
+    hostSetTime(*previousWake);
+}
+TickType_t xTaskGetTickCount() { return millis(); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+const char* pcTaskGetName(TaskHandle_t) { return "main"; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+UBaseType_t uxTaskPriorityGet(TaskHandle_t) { return 1; }
+BaseType_t xPortGetCoreID() { return 1; }
+
+// Опашките живеят до края на процеса, като на устройството
+struct HostQueue {
+    size_t itemSize;
+    size_t length;
+    size_t head = 0;
+    size_t count = 0;
+    std::vector<uint8_t> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue;
+    queue->itemSize = itemSize;
+    queue->length = length;
+    queue->items.resize((size_t)length * itemSize);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t) {
+    HostQueue* queue = static_cast<HostQueue*>(handle);
+    if (queue->count == queue->length) return pdFALSE;
+    size_t slot = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->items[slot * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t) {
+    HostQueue* queue = static_cast<HostQueue*>(handle);
+    if (queue->count == 0) return pdFALSE;
+    memcpy(item, &queue->items[queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+    return static_cast<HostQueue*>(handle)->count;
+}
+
+static int hostMutex;
+SemaphoreHandle_t xSemaphoreCreateMutex() { return &hostMutex; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+TwoWire Wire;
+long HX711::hostRaw = 0;
+long (*HX711::hostSource)(uint64_t) = nullptr;
+Adafruit_SSD1306* Adafruit_SSD1306::hostInstance = nullptr;
@@ -0,0 +1,184 @@
+// LittleFS в паметта (hal/native/LittleFS.h)
+
+#include "LittleFS.h"
+#include <map>
+#include <set>
+
+struct HostFileNode {
+    std::vector<uint8_t> data;
+};
+
+static std::map<std::string, std::shared_ptr<HostFileNode>> files;
+static std::set<std::string> directories = { "/" };
+static uint32_t writeOpens = 0;
+
+HostLittleFS LittleFS;
+
+static std::string normalize(const char* path) {
+    std::string p = path && *path ? path : "/";
+    if (p[0] != '/') p = "/" + p;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    return p;
+}
+
+static std::string parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+// ============= File =============
+
+File::File(std::shared_ptr<HostFileNode> node, const char* path, bool directory)
+    : node(node), fullPath(path), directory(directory) {
+}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!node) return 0;
+    std::vector<uint8_t>& data = node->data;
+    if (position + size > data.size()) data.resize(position + size);
+    memcpy(&data[position], buffer, size);
+    position += size;
+    return size;
+}
+
+int File::available() {
+    return node ? (int)(node->data.size() - position) : 0;
+}
+
+int File::read() {
+    if (!node || position >= node->data.size()) return -1;
+    return node->data[position++];
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!node) return 0;
+    size_t n = node->data.size() - position;
+    if (n > size) n = size;
+    memcpy(buffer, &node->data[position], n);
+    position += n;
+    return n;
+}
+
+size_t File::size() const {
+    return node ? node->data.size() : 0;
+}
+
+const char* File::name() const {
+    size_t slash = fullPath.rfind('/');
+    return fullPath.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+File File::openNextFile() {
+    if (!directory) return File();
+
+    // Преките наследници по име; индексът продължава от предишното извикване
+    std::string prefix = fullPath == "/" ? "/" : fullPath + "/";
+    size_t index = 0;
+    for (const auto& entry : files) {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0 ||
+            entry.first.find('/', prefix.size()) != std::string::npos) {
+            continue;
+        }
+        if (index++ == nextEntry) {
+            nextEntry++;
+            return File(entry.second, entry.first.c_str(), false);
+        }
+    }
+    for (const std::string& dir : directories) {
+        if (dir == fullPath || dir.compare(0, prefix.size(), prefix) != 0 ||
+            dir.find('/', prefix.size()) != std::string::npos) {
+            continue;
+        }
+        if (index++ == nextEntry) {
+            nextEntry++;
+            return File(nullptr, dir.c_str(), true);
+        }
+    }
+    return File();
+}
+
+void File::close() {
+    node.reset();
+    directory = false;
+}
+
+// ============= Файлова система =============
+
+bool HostLittleFS::begin(bool) {
+    return true;
+}
+
+bool HostLittleFS::format() {
+    hostReset();
+    return true;
+}
+
+File HostLittleFS::open(const char* path, const char* mode) {
+    std::string p = normalize(path);
+
+    if (mode[0] == 'r') {
+        if (directories.count(p)) return File(nullptr, p.c_str(), true);
+        auto it = files.find(p);
+        return it == files.end() ? File() : File(it->second, p.c_str(), false);
+    }
+
+    if (directories.count(p) || !directories.count(parentOf(p))) {
+        return File();
+    }
+    writeOpens++;
+    auto it = files.find(p);
+    if (mode[0] == 'a' && it != files.end()) {
+        File file(it->second, p.c_str(), false);
+        uint8_t ignored[64];
+        while (file.read(ignored, sizeof(ignored)) > 0) {}
+        return file;
+    }
+    // "w" - нов празен файл; отворените за четене пазят старото съдържание
+    std::shared_ptr<HostFileNode> node = std::make_shared<HostFileNode>();
+    files[p] = node;
+    return File(node, p.c_str(), false);
+}
+
+bool HostLittleFS::exists(const char* path) {
+    std::string p = normalize(path);
+    return directories.count(p) || files.count(p);
+}
+
+bool HostLittleFS::mkdir(const char* path) {
+    std::string p = normalize(path);
+    if (files.count(p) || !directories.count(parentOf(p))) return false;
+    directories.insert(p);
+    return true;
+}
+
+bool HostLittleFS::remove(const char* path) {
+    return files.erase(normalize(path)) > 0;
+}
+
+size_t HostLittleFS::totalBytes() {
+    return HOST_FS_TOTAL_BYTES;
+}
+
+size_t HostLittleFS::usedBytes() {
+    // Поне един блок на файл/директория
+    size_t blocks = directories.size();
+    for (const auto& entry : files) {
+        size_t size = entry.second->data.size();
+        blocks += size == 0 ? 1 : (size + HOST_FS_BLOCK_SIZE - 1) / HOST_FS_BLOCK_SIZE;
+    }
+    return blocks * HOST_FS_BLOCK_SIZE;
+}
+
+void HostLittleFS::hostReset() {
+    files.clear();
+    directories = { "/" };
+    writeOpens = 0;
+}
+
+uint32_t HostLittleFS::hostWrites() {
+    return writeOpens;
+}
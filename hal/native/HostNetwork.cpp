@@ -0,0 +1,103 @@
+// Мрежа и NVS за native HAL-а (hal/native/WiFi.h, HTTPClient.h, Preferences.h)
+
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <Preferences.h>
+#include <map>
+
+// ============= WiFi =============
+
+WiFiClass WiFi;
+
+void WiFiClass::emit(arduino_event_id_t event, uint8_t reason) {
+    arduino_event_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.wifi_sta_disconnected.reason = reason;
+    if (eventCallback) eventCallback(event, info);
+}
+
+// Свързването е мигновено - събитието идва още в begin()
+wl_status_t WiFiClass::begin(const char*, const char*) {
+    attempts++;
+    if (available) {
+        state = WL_CONNECTED;
+        emit(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    } else {
+        state = WL_NO_SSID_AVAIL;
+        emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 201);   // NO_AP_FOUND
+    }
+    return state;
+}
+
+bool WiFiClass::disconnect(bool) {
+    state = WL_DISCONNECTED;
+    return true;
+}
+
+void WiFiClass::hostSetNetwork(bool available, int8_t rssi) {
+    this->available = available;
+    this->rssi = rssi;
+    if (!available && state == WL_CONNECTED) {
+        state = WL_DISCONNECTED;
+        emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 200);   // BEACON_TIMEOUT
+    }
+}
+
+// ============= HTTPClient =============
+
+int HTTPClient::hostResponseCode = 200;
+uint32_t HTTPClient::hostPostCount = 0;
+std::string HTTPClient::hostLastUrl;
+std::string HTTPClient::hostLastBody;
+
+bool HTTPClient::begin(const char* url) {
+    this->url = url ? url : "";
+    return !this->url.empty();
+}
+
+int HTTPClient::POST(uint8_t* payload, size_t size) {
+    if (WiFi.status() != WL_CONNECTED) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    hostPostCount++;
+    hostLastUrl = url;
+    hostLastBody.assign((const char*)payload, size);
+    return hostResponseCode;
+}
+
+// ============= Preferences =============
+
+// "namespace/key" -> байтовете на стойността
+static std::map<std::string, std::string> nvs;
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    space = name;
+    this->readOnly = readOnly;
+    return true;
+}
+
+bool Preferences::get(const char* key, void* value, size_t size) {
+    auto it = nvs.find(space + "/" + key);
+    if (it == nvs.end() || it->second.size() != size) return false;
+    memcpy(value, it->second.data(), size);
+    return true;
+}
+
+size_t Preferences::put(const char* key, const void* value, size_t size) {
+    if (readOnly) return 0;
+    nvs[space + "/" + key].assign((const char*)value, size);
+    return size;
+}
+
+float Preferences::getFloat(const char* key, float value) { get(key, &value, sizeof(value)); return value; }
+long Preferences::getLong(const char* key, long value) { get(key, &value, sizeof(value)); return value; }
+bool Preferences::getBool(const char* key, bool value) { get(key, &value, sizeof(value)); return value; }
+uint8_t Preferences::getUChar(const char* key, uint8_t value) { get(key, &value, sizeof(value)); return value; }
+size_t Preferences::putFloat(const char* key, float value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putLong(const char* key, long value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putBool(const char* key, bool value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putUChar(const char* key, uint8_t value) { return put(key, &value, sizeof(value)); }
+
+void Preferences::hostClear() {
+    nvs.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+// LittleFS в паметта: файловете живеят до края на процеса (или до
+// hostReset()), така че "рестарт" на фърмуера в теста ги намира.
+// Заетото място се брои на блокове по 4 KB, както на флаша.
+
+#define HOST_FS_TOTAL_BYTES (1408 * 1024)   // Дялът на esp32doit-devkit-v1
+#define HOST_FS_BLOCK_SIZE  4096
+
+struct HostFileNode;
+
+class File : public Stream {
+public:
+    File() {}
+    File(std::shared_ptr<HostFileNode> node, const char* path, bool directory);
+
+    operator bool() const { return (bool)node || directory; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    size_t read(uint8_t* buffer, size_t size);
+    size_t size() const;
+    const char* name() const;     // Без директорията, като в ESP32 core 2.x
+    const char* path() const { return fullPath.c_str(); }
+    bool isDirectory() const { return directory; }
+    File openNextFile();
+    void close();
+
+private:
+    std::shared_ptr<HostFileNode> node;
+    std::string fullPath;
+    bool directory = false;
+    size_t position = 0;
+    size_t nextEntry = 0;         // За openNextFile()
+};
+
+class HostLittleFS {
+public:
+    bool begin(bool formatOnFail = false);
+    bool format();
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool mkdir(const char* path);
+    bool remove(const char* path);
+    size_t totalBytes();
+    size_t usedBytes();
+
+    // За тестовете
+    void hostReset();
+    uint32_t hostWrites();        // Отваряния за запис от старта
+};
+
+extern HostLittleFS LittleFS;
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+// NVS в паметта: стойностите остават между инстанциите до края на процеса
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end() {}
+    float getFloat(const char* key, float value = 0.0f);
+    long getLong(const char* key, long value = 0);
+    bool getBool(const char* key, bool value = false);
+    uint8_t getUChar(const char* key, uint8_t value = 0);
+    size_t putFloat(const char* key, float value);
+    size_t putLong(const char* key, long value);
+    size_t putBool(const char* key, bool value);
+    size_t putUChar(const char* key, uint8_t value);
+
+    static void hostClear();
+
+private:
+    std::string space;
+    bool readOnly = false;
+
+    bool get(const char* key, void* value, size_t size);
+    size_t put(const char* key, const void* value, size_t size);
+};
+
+#endif
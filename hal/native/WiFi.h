@@ -0,0 +1,77 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+// WiFi станция без радио: мрежата се "включва" от теста (hostSetNetwork);
+// begin() и отпадането пращат същите събития като драйвера на ESP32
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1
+} wifi_mode_t;
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP
+} arduino_event_id_t;
+
+typedef union {
+    struct {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef void (*WiFiEventFuncCb)(arduino_event_id_t event, arduino_event_info_t info);
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{ a, b, c, d } {}
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+private:
+    uint8_t octets[4];
+};
+
+class WiFiClass {
+public:
+    void persistent(bool) {}
+    bool mode(wifi_mode_t) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    void onEvent(WiFiEventFuncCb callback) { eventCallback = callback; }
+    wl_status_t begin(const char* ssid, const char* password);
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status() { return state; }
+    IPAddress localIP() { return state == WL_CONNECTED ? IPAddress(192, 168, 4, 2) : IPAddress(); }
+    int8_t RSSI() { return state == WL_CONNECTED ? rssi : 0; }
+
+    // Има ли точка за достъп; изключването прекъсва връзката (reason 200)
+    void hostSetNetwork(bool available, int8_t rssi = -60);
+    uint32_t hostConnectAttempts() { return attempts; }
+
+private:
+    WiFiEventFuncCb eventCallback = nullptr;
+    wl_status_t state = WL_IDLE_STATUS;
+    bool available = false;
+    int8_t rssi = -60;
+    uint32_t attempts = 0;
+
+    void emit(arduino_event_id_t event, uint8_t reason = 0);
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+// I2C без шина - всеки трансфер е потвърден
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1) { (void)sda; (void)scl; return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t*, size_t length) { return length; }
+    uint8_t endTransmission(bool stop = true) { (void)stop; return 0; }
+};
+
+extern TwoWire Wire;
+
+#endif
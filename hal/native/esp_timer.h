@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+// Микросекунди от старта, 64 бита - не се превърта като millis()
+int64_t esp_timer_get_time();
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef ALERT_MANAGER_H
+#define ALERT_MANAGER_H
+
+#include <Arduino.h>
+#include "DryingSessionManager.h"
+
+#define MAX_ALERT_RULES 12
+#define MAX_PENDING_WEBHOOKS 4
+
+class AlertManager {
+public:
+    enum AlertType : uint8_t {
+        ALERT_THRESHOLD,   // Загуба (%) >= value
+        ALERT_RATE,        // Средна дневна загуба (%/ден) >= value
+        ALERT_STALL,       // Промяна < value (g) за windowSec секунди
+        ALERT_ANOMALY,     // Филтрираното тегло се отмества > value (g) от референтното
+        ALERT_READY        // drying.isReady()
+    };
+
+    enum AlertAction : uint8_t {
+        ACTION_BANNER  = 0x01,   // Съобщение на OLED
+        ACTION_BUZZER  = 0x02,   // Импулс на GPIO (зумер)
+        ACTION_WEBHOOK = 0x04    // HTTP POST към webhook
+    };
+
+    // Дефиниция на правило (в flash)
+    struct RuleConfig {
+        const char* name;
+        AlertType type;
+        float value;
+        uint32_t windowSec;
+        uint8_t actions;
+        uint32_t debounceMs;     // Условието трябва да е вярно поне толкова
+        uint32_t minIntervalMs;  // Минимум между две задействания
+    };
+
+    AlertManager(int8_t buzzerPin = -1);
+
+    void begin(const RuleConfig* rules, uint8_t count, const char* webhookUrl = nullptr);
+
+    // Извиква се при всяко ново измерване (суровата проба; ALERT_ANOMALY
+    // филтрира сам)
+    void evaluate(DryingSessionManager& drying, float currentWeight);
+
+    // Зумер - извиква се от loop()
+    void update();
+
+    // Един webhook от опашката, с общ rate limit. POST-ът блокира до ~4 s,
+    // затова се вика от задачата на мрежата (NetworkManager::setConnectedWork)
+    void sendPendingWebhook();
+    static void webhookWork(void* context);
+
+    // Банер за OLED (връща true веднъж за всяко задействане)
+    bool popBanner(char* title, size_t titleSize, char* message, size_t messageSize);
+
+    uint8_t getRuleCount() { return ruleCount; }
+    uint32_t getFireCount() { return fireCount; }
+
+private:
+    // Компилирано правило - компактен запис в таблицата
+    struct Rule {
+        const char* name;
+        float value;
+        uint32_t windowMs;
+        uint32_t debounceMs;
+        uint32_t minIntervalMs;
+        uint32_t conditionSince;   // 0 = условието не е вярно
+        uint32_t lastFired;
+        float refWeight;           // За ALERT_STALL и ALERT_ANOMALY
+        uint32_t refTime;
+        uint8_t type;
+        uint8_t actions;
+        bool latched;              // Задействано, чака условието да изчезне
+    };
+
+    struct Webhook {
+        uint8_t ruleIndex;
+        float value;
+        float weight;
+    };
+
+    Rule rules[MAX_ALERT_RULES];
+    uint8_t ruleCount;
+
+    int8_t buzzerPin;
+    unsigned long buzzerOffAt;
+
+    const char* webhookUrl;
+    Webhook webhooks[MAX_PENDING_WEBHOOKS];   // Опашката се пази със spinlock
+    uint8_t webhookHead;
+    uint8_t webhookCount;
+    unsigned long lastWebhook;      // Само в задачата на мрежата
+    const unsigned long WEBHOOK_MIN_INTERVAL = 10000;
+    const unsigned long BUZZER_PULSE_MS = 500;
+
+    char bannerTitle[16];
+    char bannerMessage[24];
+    bool bannerPending;
+
+    // Медиана на последните проби за ALERT_ANOMALY - единичен удар или
+    // шум не мести теглото, изпаднало парче го мести трайно
+    static const uint8_t ANOMALY_FILTER_SIZE = 5;
+    float filterWindow[ANOMALY_FILTER_SIZE];
+    uint8_t filterHead;
+    uint8_t filterCount;
+    uint32_t fireCount;
+
+    float filterWeight(float weight);
+
+    bool checkCondition(Rule& rule, float weight, float lossPercent, float dailyRate,
+                        bool ready, uint32_t now, float& value);
+    void fire(uint8_t index, float value, float weight, uint32_t now);
+    void sendWebhook(const Webhook& hook);
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef API_HANDLER_H
+#define API_HANDLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "WebApi.h"
+#include "SampleLog.h"
+#include "Metrics.h"
+
+// JSON маршрутите на web API-то без HTTP сървъра: snapshot-и на статуса
+// и записите, кеш по поколение, ETag/304, параметрите на заявката и
+// /series през seqlock-а на SampleLog. WebServerManager го обвива за
+// ESPAsyncWebServer, bench/http_load - за сокет на Linux. Без Arduino
+// зависимости и без heap.
+//
+// publish*() вика само loop(), handle() - само задачата на HTTP. Двата
+// snapshot-а са seqlock като SampleLog: loop() не чака, читателят повтаря.
+
+#define API_READ_RETRIES        3
+#define API_SERIES_BUFFER_SIZE  (128 + SERIES_MAX_POINTS * SERIES_POINT_JSON_SIZE)
+#define API_BULK_BUFFER_SIZE    (API_SERIES_BUFFER_SIZE > METRICS_BUFFER_SIZE ? API_SERIES_BUFFER_SIZE : METRICS_BUFFER_SIZE)
+
+enum ApiRoute : uint8_t {
+    API_STATUS,      // /status/data
+    API_HISTORY,     // /history/data
+    API_SERIES       // /series
+};
+
+struct ApiResponse {
+    int code;           // 200, 304 (без тяло), 400, 404, 500, 503
+    char etag[24];      // Празен - без ETag
+    const char* body;   // В буфер на ApiHandler - валиден до следващата заявка
+};
+
+// Приключила сесия от архива (LittleFS); false - няма такава
+typedef bool (*ArchiveLoadFn)(void* context, uint16_t id, DryingSession& session);
+
+class ApiHandler {
+public:
+    ApiHandler();
+
+    // bootId различава поколенията от предишни стартирания.
+    // Без loadArchive заявките с ?session= връщат 404.
+    void begin(uint32_t bootId, SampleLog* samples, ArchiveLoadFn loadArchive, void* archiveContext);
+
+    // ----- loop() -----
+
+    // Шумът под прага не е промяна: next.currentWeight се заменя с
+    // публикуваното тегло, ако разликата е по-малка
+    void publishStatus(StatusSnapshot& next);
+    // Копие на записите само при промяна на броя, сесията или началото ѝ
+    void publishRecords(const DailyRecord* records, uint8_t count, bool active, uint32_t sessionStart);
+
+    // След форматиране id-тата на архивите започват отначало - старите
+    // ETag-ове и кешът на архивите стават невалидни
+    void invalidateArchives();
+
+    // Расте при всяка промяна на статуса или записите
+    uint32_t getGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    // ----- Задачата на HTTP -----
+
+    // query без '?' ("src=records&points=200", "" без параметри),
+    // ifNoneMatch - стойността на заглавието или ""
+    void handle(ApiRoute route, const char* query, const char* ifNoneMatch, ApiResponse& out);
+
+    // ETag на версията в out.etag; true и 304, ако браузърът я има
+    bool checkEtag(uint32_t version, const char* ifNoneMatch, ApiResponse& out) const;
+    // Същото за архивна сесия - ETag-ът зависи само от id-то
+    bool checkArchiveEtag(uint16_t archiveId, const char* ifNoneMatch, ApiResponse& out) const;
+
+    // /status/data за текущото поколение (и за SSE при свързване)
+    const char* getStatusJSON(uint32_t forGeneration);
+    // Последният публикуван статус (за SSE делтите); false - loop() пише
+    // в момента и опитите свършиха
+    bool readStatus(StatusSnapshot& out) const;
+
+    // Общ буфер за отговорите без кеш (/series, /metrics, /trace,
+    // /history/sessions) - сървърът копира тялото при изпращане
+    char* getBulkBuffer() { return bulkBuffer; }
+    size_t getBulkSize() const { return sizeof(bulkBuffer); }
+
+    // Стойността на параметър от query; false, ако липсва
+    static bool getParam(const char* query, const char* name, char* out, size_t size);
+    // ?since=&since_ts=&from=&to=&limit=&fields=&session=
+    static bool parseHistoryQuery(const char* query, HistoryQuery& out, uint16_t& archiveId);
+    // ?src=samples|records&from=&to=&points=&mode=lttb|minmax&session=
+    static bool parseSeriesQuery(const char* query, SeriesQuery& out, uint16_t& archiveId, bool& fromRecords);
+
+private:
+    std::atomic<uint32_t> generation;
+    std::atomic<uint32_t> archiveEpoch;
+    uint32_t bootId;
+    const float WEIGHT_FILTER_THRESHOLD = 1.0f;  // Като при дисплея
+
+    // Четен = стабилно, нечетен = loop() пише
+    std::atomic<uint32_t> statusSequence;
+    StatusSnapshot status;
+
+    std::atomic<uint32_t> recordsSequence;
+    DailyRecord records[MAX_DAILY_RECORDS];
+    uint8_t recordCount;
+    bool recordsActive;
+    uint32_t recordsSessionStart;
+    bool recordsSorted;
+
+    SampleLog* samples;
+    ArchiveLoadFn loadArchive;
+    void* archiveContext;
+    DryingSession archiveBuffer;
+
+    // JSON буфери (пишат се с JsonWriter), кеширани по поколение
+    char statusJson[256];
+    bool statusJsonValid;
+    uint32_t statusJsonGeneration;
+
+    char historyJson[64 + MAX_DAILY_RECORDS * 64];
+    bool historyJsonValid;
+    uint32_t historyJsonGeneration;
+    HistoryQuery historyJsonQuery;
+    uint16_t historyJsonArchive;
+    uint32_t historyJsonEpoch;
+
+    char bulkBuffer[API_BULK_BUFFER_SIZE];
+
+    bool matchEtag(const char* ifNoneMatch, ApiResponse& out) const;
+    void fail(ApiResponse& out, int code, const char* body) const;
+    void handleHistory(const char* query, const char* ifNoneMatch, ApiResponse& out);
+    void handleSeries(const char* query, const char* ifNoneMatch, ApiResponse& out);
+    bool writeHistory(const HistoryQuery& query, uint16_t archiveId, ApiResponse& out);
+    bool writeSampleSeries(const SeriesQuery& query, ApiResponse& out);
+    bool writeRecordSeries(const SeriesQuery& query, uint16_t archiveId, ApiResponse& out);
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef BUTTON_GESTURES_H
+#define BUTTON_GESTURES_H
+
+#include <stdint.h>
+
+#define BUTTON_COUNT 3
+#define BUTTON_EVENT_QUEUE 8
+
+enum ButtonEventType : uint8_t {
+    BUTTON_PRESS,          // Кратко натискане (след отпускане)
+    BUTTON_LONG_PRESS,     // Задържане - още докато бутонът е натиснат
+    BUTTON_DOUBLE_PRESS    // Две кратки натискания (само ако е разрешено)
+};
+
+struct ButtonEvent {
+    uint8_t button;
+    ButtonEventType type;
+    uint32_t timeMs;
+};
+
+// Разпознаване на натискания от фронтовете на бутоните - без Arduino,
+// компилира се и на host. Фронтовете идват с времето си от прекъсването,
+// затова резултатът не зависи от това кога loop() стига до poll().
+//
+// Debounce: ново ниво се приема, ако е стояло DEBOUNCE_MS без друг фронт.
+// При разрешено двойно натискане единичното се потвърждава след
+// DOUBLE_PRESS_MS без второ натискане.
+class ButtonGestures {
+public:
+    ButtonGestures();
+
+    void reset(uint8_t button, bool pressed);
+    void enableDoublePress(uint8_t button, bool enable);
+
+    // Фронт (новото ниво) в момента timeMs; времената не намаляват
+    void edge(uint8_t button, bool pressed, uint32_t timeMs);
+    // Таймерите (задържане, двойно натискане, debounce) до nowMs
+    void poll(uint32_t nowMs);
+
+    bool pop(ButtonEvent& event);
+    bool isPressed(uint8_t button) const;
+
+    uint32_t getDroppedEvents() const { return droppedEvents; }
+
+    const uint32_t DEBOUNCE_MS = 30;
+    const uint32_t LONG_PRESS_MS = 3000;
+    const uint32_t DOUBLE_PRESS_MS = 300;
+
+private:
+    enum State : uint8_t {
+        STATE_IDLE,
+        STATE_DOWN,            // Първо натискане
+        STATE_WAIT_SECOND,     // Отпуснат, чака второ натискане
+        STATE_SECOND_DOWN      // Второ натискане
+    };
+
+    struct Button {
+        bool raw;              // Последният фронт
+        uint32_t rawAt;
+        bool stable;           // След debounce
+        State state;
+        uint32_t pressedAt;
+        uint32_t releasedAt;
+        bool longFired;
+        bool doublePress;
+    };
+
+    Button buttons[BUTTON_COUNT];
+
+    ButtonEvent events[BUTTON_EVENT_QUEUE];
+    uint8_t eventHead;
+    uint8_t eventCount;
+    uint32_t droppedEvents;
+
+    void advance(uint8_t index, uint32_t timeMs);
+    void checkTimers(uint8_t index, uint32_t timeMs);
+    void transition(uint8_t index, bool pressed, uint32_t timeMs);
+    void emit(uint8_t index, ButtonEventType type, uint32_t timeMs);
+};
+
+#endif
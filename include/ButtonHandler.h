@@ -5,6 +5,11 @@
 #include "ScaleManager.h"
 #include "DryingSessionManager.h"
 #include "DisplayManager.h"
+#include "ButtonGestures.h"
+#include <atomic>
+
+// Фронтове от прекъсванията до loop() - с времето им
+#define BUTTON_EDGE_QUEUE 32
 
 
 class ButtonHandler {
@@ -17,12 +22,32 @@ public:
     ButtonHandler(uint8_t tarePin, uint8_t unitPin, uint8_t startPin);
     
     void begin();
-    void update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display, float currentWeight);
+    void update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display);
     
     OperationMode getMode();
     void setMode(OperationMode mode);
+    
+    // Старт/край на сесия - общи за START (задържане) и web API
+    bool startSession(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display,
+                      float targetLossPercent = 40.0f);
+    void stopSession(DryingSessionManager& drying, DisplayManager& display);
      int getHistoryIndex() { return historyIndex; }
 
+    // Какво трябва да направи UI-ят в main.cpp след update()/startSession()
+    enum UiRequest : uint8_t {
+        UI_MESSAGE_SHOWN = 0x01,   // На дисплея е временно съобщение
+        UI_REDRAW        = 0x02    // Екранът трябва да се прерисува
+    };
+    uint8_t popUiRequests();
+    
+    // Фронт от запис/сценарий - минава през същото разпознаване като
+    // прекъсванията (bench/ui_replay.cpp, бутони без хардуер)
+    void injectEdge(uint8_t button, bool pressed, uint32_t timeMs);
+    // Всеки фронт на Serial като ред от сценарий: "<ms> down|up TARE|UNIT|START"
+    void setEdgeLog(bool enabled);
+    bool isEdgeLogEnabled() { return edgeLog; }
+    static const char* buttonName(uint8_t button);
+
 private:
     uint8_t btnTarePin;
     uint8_t btnUnitPin;
@@ -30,26 +55,33 @@ private:
     
     OperationMode currentMode;
     int historyIndex;  // За навигация в историята
+    uint8_t uiRequests;
     
-    // Button states
-    bool lastButtonStates[3];
-    unsigned long buttonPressTime[3];
-    bool buttonHoldDetected[3];
+    // Прекъсванията пишат фронтовете тук (един писач - ISR-ите на core 1),
+    // update() ги чете и ги подава на gestures
+    struct RawEdge {
+        uint8_t button;
+        bool pressed;
+        uint32_t timeMs;
+    };
+    struct PinContext {
+        ButtonHandler* handler;
+        uint8_t button;
+        uint8_t pin;
+    };
+    RawEdge edges[BUTTON_EDGE_QUEUE];
+    std::atomic<uint8_t> edgeHead;     // Пише ISR
+    std::atomic<uint8_t> edgeTail;     // Пише update()
+    volatile uint32_t edgesDropped;
+    PinContext pinContexts[BUTTON_COUNT];
+    bool edgeLog;
+    ButtonGestures gestures;
     
-    // Timing
-    unsigned long lastButtonCheck;
-    const unsigned long DEBOUNCE_MS = 200;
-    const unsigned long HOLD_MS = 3000;
+    static void IRAM_ATTR onEdge(void* arg);
     
     // Button handling
-    void handleNormalMode(ScaleManager& scale, DisplayManager& display);
-    void handleDryingMode(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display, float currentWeight);
-    
-    bool isButtonPressed(uint8_t buttonIndex);
-    bool isButtonHeld(uint8_t buttonIndex);
-    void resetButton(uint8_t buttonIndex);
-
-
+    void handleNormalMode(const ButtonEvent& event, ScaleManager& scale, DisplayManager& display);
+    void handleDryingMode(const ButtonEvent& event, DryingSessionManager& drying, DisplayManager& display);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef DISPLAY_FORMAT_H
+#define DISPLAY_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Текстът на OLED екраните - без Arduino зависимости и без heap:
+// числата се форматират в буфер на стека, позициите се кешират.
+// Компилира се и на host (bench/display_alloc.cpp).
+
+// Шрифтът по подразбиране на Adafruit_GFX: 6x8 px при размер 1
+#define FONT_CHAR_WIDTH  6
+#define FONT_CHAR_HEIGHT 8
+#define DISPLAY_MAX_TEXT_SIZE 3
+#define DISPLAY_MAX_LINE 22        // 128 / 6 + терминираща нула
+
+// Единиците - в реда на ScaleManager::WeightUnit
+struct UnitFormat {
+    const char* suffix;       // "g"
+    const char* name;         // "GRAMS"
+    float perGram;
+    float zeroThreshold;      // Под 2 g се показва 0.0
+    uint8_t decimals;
+};
+
+const UnitFormat& unitFormat(uint8_t unit);
+
+// Число с фиксирани знаци след точката (закръгляне, без printf/dtoa)
+size_t formatFixed(char* out, size_t size, float value, uint8_t decimals);
+
+// Тегло в грамове -> текст в дадената единица, като на нормалния екран
+size_t formatWeight(char* out, size_t size, float grams, uint8_t unit);
+
+// Добавяне на части към ред в буфер; при препълване текстът се отрязва
+class TextBuilder {
+public:
+    TextBuilder(char* buffer, size_t size);
+
+    TextBuilder& add(const char* s);
+    TextBuilder& add(int32_t v);
+    TextBuilder& add(float v, uint8_t decimals);
+
+    const char* c_str() const { return buf; }
+    size_t length() const { return len; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+};
+
+struct TextLayout {
+    int16_t x;
+    int16_t y;
+    uint8_t size;
+};
+
+// Позиции на центриран текст по размер на шрифта и дължина.
+// Смятат се при първото поискване, после се четат от таблицата.
+class LayoutCache {
+public:
+    LayoutCache(int16_t screenWidth, int16_t screenHeight);
+
+    int16_t centeredX(uint8_t textSize, uint8_t length);
+
+    // Голямото тегло на нормалния екран: размер 3, или 2 ако не се събира
+    const TextLayout& weight(uint8_t length);
+
+    // Текст, подравнен вдясно (единицата долу вдясно)
+    int16_t rightX(uint8_t textSize, uint8_t length, int16_t margin);
+
+private:
+    int16_t width;
+    int16_t height;
+
+    static const int16_t UNMEASURED = -32768;
+    int16_t centerX[DISPLAY_MAX_TEXT_SIZE][DISPLAY_MAX_LINE];
+    TextLayout weightLayout[DISPLAY_MAX_LINE];
+    bool weightMeasured[DISPLAY_MAX_LINE];
+};
+
+#endif
@@ -6,11 +6,28 @@
 #include <Adafruit_SSD1306.h>
 #include "ScaleManager.h"
 #include "DryingSessionManager.h"
+#include "DisplayFormat.h"
+#include "Sparkline.h"
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 #define SCREEN_ADDRESS 0x3C
+#define SCREEN_PAGES (SCREEN_HEIGHT / 8)
+#define SCREEN_FRAME_BYTES (SCREEN_WIDTH * SCREEN_PAGES)
+
+// I2C към OLED: Fast-mode (400 kHz) или Fast-mode Plus, ако панелът го
+// поддържа (проверява се при begin()). OLED_I2C_CLOCK_MAX=400000 го изключва.
+#define I2C_CLOCK_FAST 400000
+#ifndef OLED_I2C_CLOCK_MAX
+#define OLED_I2C_CLOCK_MAX 1000000
+#endif
+
+// Задачата, която праща кадрите по I2C - на core 0 под async_tcp,
+// така че нито loop(), нито HTTP чакат дисплея
+#define DISPLAY_TASK_CORE     0
+#define DISPLAY_TASK_PRIORITY 1
+#define DISPLAY_TASK_STACK    3072
 
 class DisplayManager {
 public:
@@ -18,7 +35,8 @@ public:
         MODE_NORMAL,           // Нормален кантар
         MODE_DRYING_LIVE,      // Сушене - Live данни
         MODE_DRYING_STATS,     // Сушене - Статистика
-        MODE_DRYING_HISTORY    // Сушене - История
+        MODE_DRYING_HISTORY,   // Сушене - История
+        MODE_DRYING_GRAPH      // Сушене - Графики (24 ч и цялата сесия)
     };
 
     DisplayManager();
@@ -29,13 +47,16 @@ public:
     DisplayMode getMode();
     
     // Normal Mode екрани
-    void showNormalWeight(float weight, String unit);
-    void showUnitChange(String unit);
+    // Теглото е в грамове - превръща се и се форматира по единицата
+    void showNormalWeight(float grams, ScaleManager::WeightUnit unit);
+    void showUnitChange(ScaleManager::WeightUnit unit);
     
     // Drying Mode екрани
     void showDryingLive(DryingSessionManager& drying, float currentWeight);
     void showDryingStats(DryingSessionManager& drying);
     void showDryingHistory(DryingSessionManager& drying, int recordIndex);
+    // Горе теглото за последните 24 ч, долу загубата спрямо целта
+    void showDryingGraph(DryingSessionManager& drying, const Sparkline& day, const Sparkline& loss);
     
     // Калибрация екрани
     void showCalibrationStep1();
@@ -49,14 +70,41 @@ public:
     void showDailyRecorded(int day, float weight, float lossPercent);
     
     // Помощни
-    void showMessage(String title, String message, int delayMs = 2000);
+    void showMessage(const char* title, const char* message, int delayMs = 2000);
     void drawProgressBar(int x, int y, int width, int height, float percent, float target);
+    void drawSparkline(const Sparkline& series, int y, int height, float low, float high);
+    
+    // Статистика на изпращането (serial "info")
+    void printStats();
 
 private:
     Adafruit_SSD1306 display;
     DisplayMode currentMode;
     
-    void centerText(String text, int y, int textSize = 1);
+    // show*() рисуват в буфера на Adafruit в loop(); flush() го копира в
+    // pendingFrame, а задачата го праща - само разликата спрямо lastFrame
+    uint8_t pendingFrame[SCREEN_FRAME_BYTES];   // Пази се с frameMux
+    bool framePending;
+    uint8_t workFrame[SCREEN_FRAME_BYTES];      // Само в задачата
+    uint8_t lastFrame[SCREEN_FRAME_BYTES];      // Какво има на OLED
+    TaskHandle_t taskHandle;
+    int8_t monitorId;
+    uint32_t i2cClock;
+    uint32_t framesFlushed;
+    uint32_t bytesSent;
+    const uint32_t DISPLAY_MIN_FRAME_MS = 50;    // До 20 кадъра/s
+    const uint32_t DISPLAY_RESYNC_MS = 60000;    // Пълен кадър при липса на промени
+    const uint32_t DISPLAY_RETRY_MS = 1000;      // Повторно изпращане след I2C грешка
+    const uint8_t I2C_DATA_CHUNK = 31;
+    
+    void flush();
+    static void displayTask(void* context);
+    void runTask();
+    bool sendFrame(bool full);
+    bool sendPage(uint8_t page, uint8_t firstColumn, uint8_t lastColumn, const uint8_t* row);
+    LayoutCache layouts;
+    
+    void centerText(const char* text, int y, int textSize = 1);
 };
 
 #endif
\ No newline at end of file
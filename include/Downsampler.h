@@ -0,0 +1,75 @@
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <stdint.h>
+
+// Поточно намаляване на серия до зададен брой точки - едно минаване,
+// O(1) памет, независимо от дължината на серията.
+//
+// MODE_MINMAX: времевият диапазон се дели на points/2 кофи, от всяка се
+//   връщат минимумът и максимумът (по реда им във времето).
+// MODE_LTTB:   Largest-Triangle-Three-Buckets. За да остане поточен и с
+//   ограничена памет, кандидатите в кофа са само нейните min и max
+//   (MinMaxLTTB). Изборът в кофа i става, когато кофа i+1 е завършена и
+//   средното ѝ е известно. Първата и последната точка винаги се връщат.
+//
+// Точките трябва да идват с ненамаляващо t; останалите се пропускат.
+class Downsampler {
+public:
+    enum Mode : uint8_t {
+        MODE_LTTB,
+        MODE_MINMAX
+    };
+
+    typedef void (*EmitFn)(void* context, uint32_t t, float value);
+
+    Downsampler(Mode mode, uint32_t from, uint32_t to, uint16_t points,
+                EmitFn emit, void* context);
+
+    void add(uint32_t t, float value);
+    void finish();
+
+    uint32_t getInputCount() const { return inputCount; }
+    uint16_t getOutputCount() const { return outputCount; }
+
+private:
+    struct Point {
+        uint32_t t;
+        float v;
+    };
+
+    struct Bucket {
+        int32_t index;     // -1 = празна
+        uint32_t count;
+        double sumT;
+        double sumV;
+        Point minPoint;
+        Point maxPoint;
+    };
+
+    Mode mode;
+    uint32_t from;
+    uint32_t to;
+    uint16_t bucketCount;
+    EmitFn emit;
+    void* context;
+
+    Bucket pending;        // LTTB: чака средното на следващата кофа
+    Bucket current;
+    Point anchor;          // LTTB: последната избрана точка
+    Point last;            // LTTB: задържана, докато не дойде следваща
+    bool hasFirst;
+    bool hasHeld;
+
+    uint32_t inputCount;
+    uint16_t outputCount;
+
+    int32_t bucketOf(uint32_t t) const;
+    void resetBucket(Bucket& bucket, int32_t index);
+    void addToBucket(Bucket& bucket, const Point& p);
+    void output(const Point& p);
+    void flushMinMax(const Bucket& bucket);
+    void selectLttb(const Bucket& bucket, double cT, double cV);
+};
+
+#endif
@@ -23,12 +23,17 @@ public:
     float getCurrentLossPercent();
     float getRemainingLossPercent();
     int estimateDaysRemaining();
+    float getAverageDailyLoss();
     bool isReady();
     
     // История
     DailyRecord* getRecord(int index);
     DailyRecord* getLastRecord();
     int getRecordCount();
+    
+    // Секунди от старта за timestamp-ите на сесията. От 64-битовия
+    // esp_timer - millis() / 1000 се превърта след 49.7 дни
+    static uint32_t uptimeSeconds();
 
 private:
     StorageManager& storage;
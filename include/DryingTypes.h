@@ -0,0 +1,37 @@
+#ifndef DRYING_TYPES_H
+#define DRYING_TYPES_H
+
+#include <stdint.h>
+
+#define MAX_DAILY_RECORDS 60  // До 60 дни история
+
+struct DailyRecord {
+    uint8_t day;
+    uint32_t timestamp;
+    float weight;
+    float lossPercent;
+    float dayChange;
+};
+
+struct DryingSession {
+    bool isActive;
+    float initialWeight;
+    float targetLossPercent;
+    uint32_t startTimestamp;
+    uint8_t currentDay;
+     uint32_t lastRecordTimestamp; 
+    
+    DailyRecord records[MAX_DAILY_RECORDS];
+    uint8_t recordCount;
+};
+
+// Приключила сесия в архива (/archive/<id>.bin)
+struct SessionArchiveInfo {
+    uint16_t id;
+    uint32_t startTimestamp;
+    float initialWeight;
+    float targetLossPercent;
+    uint8_t recordCount;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <stdint.h>
+
+// Типизирани събития между модулите: кой публикува не знае кой слуша.
+// Всеки тип събитие има своя статична таблица с абонати (без heap);
+// publish() вика абонатите синхронно, в задачата на публикуващия.
+// Абонаментите се правят в setup(), преди задачите да тръгнат -
+// след това таблиците само се четат.
+
+#define EVENT_MAX_SUBSCRIBERS 6
+
+// Нова проба от кантара (loop(), след опашката на Sampler)
+struct WeightSampleEvent {
+    uint32_t timestampMs;
+    float weight;
+};
+
+// Дневен запис в сесията (ръчен, автоматичен или от web API)
+struct RecordAddedEvent {
+    uint8_t day;
+    uint8_t recordCount;
+    uint32_t timestamp;
+    float weight;
+    float lossPercent;
+};
+
+struct SessionStartedEvent {
+    uint32_t startTimestamp;
+    float initialWeight;
+    float targetLossPercent;
+};
+
+struct SessionEndedEvent {
+    uint32_t startTimestamp;
+    uint8_t recordCount;
+    float lossPercent;        // Последният запис
+};
+
+struct TareDoneEvent {
+    long offset;              // Нова нула на HX711 (raw)
+};
+
+// Трайно отместване на филтрираното тегло (правило ALERT_ANOMALY)
+struct AnomalyDetectedEvent {
+    const char* rule;
+    float jump;               // g
+    float weight;
+};
+
+template <typename E>
+class EventChannel {
+public:
+    typedef void (*Handler)(const E& event, void* context);
+
+    static bool subscribe(Handler handler, void* context) {
+        if (count >= EVENT_MAX_SUBSCRIBERS) {
+            return false;
+        }
+        subscribers[count].handler = handler;
+        subscribers[count].context = context;
+        count++;
+        return true;
+    }
+
+    static void publish(const E& event) {
+        for (uint8_t i = 0; i < count; i++) {
+            subscribers[i].handler(event, subscribers[i].context);
+        }
+    }
+
+    static uint8_t subscriberCount() { return count; }
+
+private:
+    struct Subscriber {
+        Handler handler;
+        void* context;
+    };
+    static Subscriber subscribers[EVENT_MAX_SUBSCRIBERS];
+    static uint8_t count;
+};
+
+template <typename E>
+typename EventChannel<E>::Subscriber EventChannel<E>::subscribers[EVENT_MAX_SUBSCRIBERS];
+template <typename E>
+uint8_t EventChannel<E>::count = 0;
+
+// EventBus::subscribe<RecordAddedEvent>(handler) / EventBus::publish(event)
+class EventBus {
+public:
+    // false - таблицата на типа е пълна (EVENT_MAX_SUBSCRIBERS)
+    template <typename E>
+    static bool subscribe(typename EventChannel<E>::Handler handler, void* context = nullptr) {
+        return EventChannel<E>::subscribe(handler, context);
+    }
+
+    template <typename E>
+    static void publish(const E& event) {
+        EventChannel<E>::publish(event);
+    }
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef JOB_MANAGER_H
+#define JOB_MANAGER_H
+
+#include <Arduino.h>
+#include "ScaleManager.h"
+#include "DryingSessionManager.h"
+#include "DisplayManager.h"
+#include "ButtonHandler.h"
+
+#define MAX_JOBS 8
+
+// Операции, поискани от web API. HTTP задачата само ги добавя в опашката;
+// изпълняват се от loop() през update(), по една стъпка на извикване,
+// така че нито HTTP handler-ът, нито loop() чакат дълго.
+class JobManager {
+public:
+    enum JobType : uint8_t {
+        JOB_TARE,
+        JOB_START_SESSION,
+        JOB_STOP_SESSION,
+        JOB_RECORD_NOW,
+        JOB_CALIBRATE
+    };
+
+    enum JobState : uint8_t {
+        JOB_QUEUED,
+        JOB_RUNNING,
+        JOB_DONE,
+        JOB_FAILED
+    };
+
+    struct Job {
+        uint16_t id;           // 0 = празен слот
+        JobType type;
+        JobState state;
+        uint8_t progress;      // 0-100
+        float param;           // Целева загуба / калибрационно тегло
+        char message[32];
+    };
+
+    JobManager();
+
+    // От HTTP задачата. Връща id или 0, ако опашката е пълна.
+    uint16_t submit(JobType type, float param);
+    bool getJob(uint16_t id, Job& out);
+
+    // От loop()
+    void update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display,
+                ButtonHandler& buttons, float currentWeight);
+
+    // Калибрацията държи дисплея, докато върви
+    bool ownsDisplay();
+
+    // Съобщение за OLED при край на задача (като AlertManager::popBanner)
+    bool popBanner(char* title, size_t titleSize, char* message, size_t messageSize);
+
+    static const char* typeName(JobType type);
+    static const char* stateName(JobState state);
+
+private:
+    Job jobs[MAX_JOBS];
+    uint16_t nextId;
+    int8_t running;           // Индекс на текущата задача, -1 = няма
+
+    // Стъпки на калибрацията (като ScaleManager::performCalibration)
+    enum CalibrationPhase : uint8_t {
+        CAL_REMOVE,        // Махни тежестта
+        CAL_TARE,          // Проби без тежест
+        CAL_HANG,          // Закачи известното тегло
+        CAL_LOAD,          // Проби с тежест
+        CAL_VERIFY         // Контролни проби с новия фактор
+    };
+
+    // Състояние на текущата задача (само от loop())
+    uint8_t phase;
+    unsigned long phaseStart;
+    uint8_t sampleCount;
+    int64_t sampleSum;
+    long calibrationOffset;
+    float calibrationFactor;
+
+    char bannerTitle[16];
+    char bannerMessage[24];
+    bool bannerPending;
+
+    const unsigned long SAMPLE_TIMEOUT_MS = 5000;
+    const uint8_t TARE_SAMPLES = 10;
+    const uint8_t CALIBRATION_SAMPLES = 10;
+    const unsigned long CALIBRATION_REMOVE_MS = 5000;
+    const unsigned long CALIBRATION_HANG_MS = 12000;
+    const float CALIBRATION_MAX_ERROR = 5.0f;   // %
+
+    int8_t findQueued();
+    void setProgress(uint8_t progress, const char* message);
+    void finish(bool ok, const char* message);
+    void enterPhase(uint8_t next);
+    bool collectSample(ScaleManager& scale, uint8_t target);
+    void setBanner(const char* title, const char* message);
+
+    void runTare(ScaleManager& scale);
+    void runCalibration(ScaleManager& scale, DisplayManager& display, float knownWeight);
+};
+
+#endif
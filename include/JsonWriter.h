@@ -0,0 +1,60 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Минимален JSON writer върху буфер на извикващия - без heap алокации.
+// При препълване изходът се отрязва и overflowed() връща true.
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t capacity);
+
+    void reset();
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(bool v);
+    JsonWriter& value(int32_t v);
+    JsonWriter& value(uint32_t v);
+    JsonWriter& value(float v, uint8_t decimals);
+    JsonWriter& value(const char* v);
+    JsonWriter& null();
+
+    // key + value
+    JsonWriter& field(const char* name, bool v) { return key(name).value(v); }
+    JsonWriter& field(const char* name, int32_t v) { return key(name).value(v); }
+    JsonWriter& field(const char* name, uint32_t v) { return key(name).value(v); }
+    JsonWriter& field(const char* name, float v, uint8_t decimals) { return key(name).value(v, decimals); }
+    JsonWriter& field(const char* name, const char* v) { return key(name).value(v); }
+
+    const char* c_str() const { return buf; }
+    size_t length() const { return len; }
+    bool overflowed() const { return overflow; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+
+    // Бит на ниво: 1 = в текущия контейнер вече има елемент
+    uint32_t hasItems;
+    uint8_t depth;
+    bool afterKey;
+
+    void separator();
+    void put(char c);
+    void put(const char* s, size_t n);
+    void putUnsigned(uint64_t v);
+    void putString(const char* s);
+    void open(char c);
+    void close(char c);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Броячи и хистограми на фърмуера за /metrics (Prometheus text format).
+// Обновяват се без заключване (relaxed atomics) от която и да е задача;
+// експозицията се пише в подаден буфер, без heap и без printf.
+// Всичко е 32-битово: сумите на хистограмите се превъртат (~71 мин в µs),
+// което rate() в Prometheus понася като рестарт на брояча.
+
+#define METRICS_MAX_BUCKETS 8
+#define METRICS_MAX_TASKS 8
+
+// Най-лошият случай (всички стойности по 10 цифри, 8 задачи) е ~14.5 KB
+#define METRICS_BUFFER_SIZE 16384
+
+class MetricCounter {
+public:
+    MetricCounter() : value(0) {}
+
+    void inc(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value;
+};
+
+// Последна стойност (set), за еднократни времена и състояния
+class MetricGauge {
+public:
+    MetricGauge() : value(0) {}
+
+    void set(uint32_t v) { value.store(v, std::memory_order_relaxed); }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value;
+};
+
+class MetricHistogram {
+public:
+    MetricHistogram();
+
+    // bounds - горни граници (le), възходящо, до METRICS_MAX_BUCKETS
+    void init(const uint32_t* bounds, uint8_t count);
+    void observe(uint32_t value);
+
+    uint8_t getBoundCount() const { return boundCount; }
+    uint32_t getBound(uint8_t i) const { return bounds[i]; }
+    uint32_t getBucket(uint8_t i) const { return buckets[i].load(std::memory_order_relaxed); }
+    uint32_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint32_t getSum() const { return sum.load(std::memory_order_relaxed); }
+
+private:
+    const uint32_t* bounds;
+    uint8_t boundCount;
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1];  // Последната = +Inf
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> sum;
+};
+
+// HTTP маршрути с отделна статистика
+enum HttpRoute : uint8_t {
+    ROUTE_MONITOR_PAGE,
+    ROUTE_HISTORY_PAGE,
+    ROUTE_STATUS_DATA,
+    ROUTE_HISTORY_DATA,
+    ROUTE_HISTORY_SESSIONS,
+    ROUTE_SERIES,
+    ROUTE_METRICS,
+    ROUTE_API_CONTROL,
+    ROUTE_API_JOBS,
+    ROUTE_TRACE,
+    ROUTE_COUNT
+};
+
+// Пътят на маршрута ("/status/data") - статичен низ
+const char* httpRouteName(HttpRoute route);
+
+struct FirmwareMetrics {
+    FirmwareMetrics();
+
+    MetricHistogram loopTimeUs;          // Едно минаване на loop() без чакането на проба
+    MetricCounter scaleSamplesRead;
+    MetricCounter scaleSamplesDropped;   // HX711 не е готов/зает или loop() не е взел пробата
+    MetricHistogram samplingJitterMs;    // |интервал - SAMPLE_INTERVAL_MS|
+
+    MetricCounter httpRequests[ROUTE_COUNT];
+    MetricHistogram httpLatencyUs[ROUTE_COUNT];  // Време в handler-а
+    MetricCounter httpRejected;          // 503 при пълна опашка
+    MetricCounter jsonBytes;             // HTTP отговори + SSE събития
+
+    MetricCounter fsBytesWritten;        // LittleFS
+    MetricCounter nvsWrites;             // Preferences put*
+    MetricCounter wifiReconnects;
+
+    MetricHistogram displayFlushUs;      // Изпращане на кадър към OLED
+    MetricCounter displayBytesSent;      // Байтове данни по I2C
+    MetricCounter displayBytesSaved;     // Спрямо пълен кадър от 1024 байта
+
+    // Време от старта; 0 = още не се е случило
+    MetricGauge bootToFirstSampleMs;
+    MetricGauge bootToWifiMs;
+};
+
+extern FirmwareMetrics metrics;
+
+// Задача на FreeRTOS (от TaskMonitor)
+struct MetricsTask {
+    const char* name;
+    uint8_t core;
+    uint8_t priority;
+    uint32_t stackFreeBytes;   // Най-малко свободен стек от старта
+    uint32_t cpuMs;            // Време в работа (без чакане)
+};
+
+// Стойности, които се четат в момента на заявката
+struct MetricsGauges {
+    uint32_t uptimeSec;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t largestFreeBlock;
+    int32_t wifiRssi;
+    bool wifiConnected;
+    const MetricsTask* tasks;
+    uint8_t taskCount;
+};
+
+// Пише експозицията в buffer; връща дължината или 0, ако не се събира
+size_t writeMetrics(char* buffer, size_t size, const FirmwareMetrics& m, const MetricsGauges& gauges);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <Arduino.h>
+#include "ScaleManager.h"
+#include "StorageManager.h"
+#include "DryingSessionManager.h"
+#include "DisplayManager.h"
+#include "SystemState.h"
+#include "SampleLog.h"
+#include "Sparkline.h"
+#include "WebApi.h"
+
+// Микробенчмарк на горещите пътища с 1, 60 и 1000 записа/проби:
+// обработка на проба (стабилност, минутен лог, графики), convertWeight,
+// JSON на /status/data, /history/data и /series, saveSession/loadSession,
+// съставяне на OLED кадър и цената на TRACE_SCOPE. Мери в цикли (ESP.getCycleCount()) - на
+// устройството от serial "bench" (build с -DMICROBENCH), на Linux от
+// bench/microbench.cpp през HAL-а. Резултатът е JSON, по един случай на
+// ред, за сравнение между версии.
+//
+// Работните данни (~21 KB) са в обекта, не в модулите на фърмуера -
+// бенчмаркът не пипа текущата сесия, лога и графиките.
+
+#define MICROBENCH_MAX_RESULTS 24
+#define MICROBENCH_ROUNDS      5
+#define MICROBENCH_JSON_SIZE   (64 + SERIES_DEFAULT_POINTS * SERIES_POINT_JSON_SIZE)
+
+struct BenchResult {
+    const char* name;
+    uint16_t size;          // Записи/проби в случая
+    uint32_t iterations;    // Операции на кръг
+    uint32_t bestCycles;    // На операция, най-бързият кръг
+    uint32_t meanCycles;    // На операция, всички кръгове
+    uint32_t bytes;         // Размер на изхода (JSON), 0 ако няма
+};
+
+class MicroBench {
+public:
+    MicroBench(ScaleManager& scale, StorageManager& storage, DisplayManager& display);
+
+    // saveSession/loadSession пишат в собствени файлове и после ги трият -
+    // записаната сесия остава
+    void run();
+
+    // {"target":..,"cpu_mhz":..,"results":[ по един ред на случай ]}
+    void printJson(Print& out) const;
+
+    uint8_t getResultCount() const { return resultCount; }
+    const BenchResult& getResult(uint8_t index) const { return results[index]; }
+
+private:
+    ScaleManager& scale;
+    StorageManager& storage;
+    DisplayManager& display;
+
+    // Копия на модулите по пътя на пробата и синтетична сесия
+    DryingSessionManager drying;
+    StabilityTracker stability;
+    SampleLog log;
+    Sparkline dayGraph;
+    Sparkline lossGraph;
+    char json[MICROBENCH_JSON_SIZE];
+
+    BenchResult results[MICROBENCH_MAX_RESULTS];
+    uint8_t resultCount;
+
+    template <typename F>
+    void measure(const char* name, uint16_t size, uint32_t iterations, F operation);
+
+    void fillSession(uint8_t records);
+    void fillGraphs(uint16_t samples);
+    void benchSamplePath();
+    void benchJson();
+    void benchStorage();
+    void benchDisplay();
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef NETWORK_MANAGER_H
+#define NETWORK_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <atomic>
+
+// Собствена задача на core 0 (с WiFi и async_tcp), извън пътя на пробите
+#define NETWORK_TASK_CORE      0
+#define NETWORK_TASK_PRIORITY  2
+#define NETWORK_TASK_STACK     4096    // С HTTPClient на webhook-а
+#define NETWORK_TASK_PERIOD_MS 100
+
+// WiFi връзка като неблокираща state machine.
+// Събитията на WiFi драйвера само вдигат флагове; update() от задачата
+// на мрежата ги обработва и при отпадане свързва отново с експоненциален backoff.
+class NetworkManager {
+public:
+    enum State : uint8_t {
+        NET_IDLE,
+        NET_CONNECTING,
+        NET_CONNECTED,
+        NET_BACKOFF        // Чака до следващия опит
+    };
+
+    typedef void (*Work)(void* context);
+
+    NetworkManager();
+
+    // Работа, която чака мрежата (webhook POST); задачата я вика на всеки
+    // период, докато има връзка. Задава се преди begin().
+    void setConnectedWork(Work work, void* context);
+
+    // Пуска задачата, която вика update()
+    void begin(const char* ssid, const char* password);
+    void update();
+
+    // Безопасни от всяка задача
+    State getState() { return state.load(); }
+    bool isConnected() { return state.load() == NET_CONNECTED; }
+    String getIPAddress();
+
+private:
+    const char* ssid;
+    const char* password;
+
+    std::atomic<State> state;     // Пише само задачата на мрежата
+    unsigned long attemptStart;
+    unsigned long retryAt;
+    unsigned long backoffMs;
+    uint16_t attempt;
+    bool everConnected;
+
+    const unsigned long CONNECT_TIMEOUT_MS = 15000;
+    const unsigned long BACKOFF_MIN_MS = 1000;
+    const unsigned long BACKOFF_MAX_MS = 60000;
+    const unsigned long STALE_EVENT_MS = 500;  // Disconnect от предишния опит
+
+    // Флагове от WiFi задачата
+    enum EventFlag : uint8_t {
+        EVENT_GOT_IP       = 0x01,
+        EVENT_DISCONNECTED = 0x02
+    };
+    static std::atomic<uint8_t> pendingEvents;
+    static std::atomic<uint8_t> lastReason;
+    static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+
+    Work connectedWork;
+    void* connectedContext;
+
+    TaskHandle_t taskHandle;
+    int8_t monitorId;
+    static void networkTask(void* context);
+    void runTask();
+
+    void startAttempt();
+    void enterBackoff(const char* why);
+};
+
+#endif
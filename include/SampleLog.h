@@ -0,0 +1,49 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stdint.h>
+#include <atomic>
+
+#define SAMPLE_LOG_CAPACITY 1440   // 24 часа по една минута
+#define SAMPLE_LOG_INTERVAL 60     // секунди на проба
+
+struct WeightSample {
+    uint32_t timestamp;   // секунди (като DailyRecord::timestamp)
+    float weight;
+};
+
+// Минутен лог на теглото в RAM (ring buffer).
+// Измерванията в рамките на минутата се осредняват до една проба.
+// Пише само една задача; читателите от други задачи ползват
+// beginRead()/endRead() и повтарят, ако междувременно е имало запис.
+class SampleLog {
+public:
+    SampleLog();
+
+    void addReading(uint32_t timestamp, float weight);
+    void clear();
+
+    // Брой проби и проба i (0 = най-старата)
+    uint16_t size() const { return count; }
+    WeightSample at(uint16_t index) const;
+
+    uint32_t beginRead() const;
+    bool endRead(uint32_t token) const;
+
+private:
+    WeightSample samples[SAMPLE_LOG_CAPACITY];
+    uint16_t head;     // Следващата позиция за запис
+    uint16_t count;
+
+    // Текуща минута
+    uint32_t bucketStart;
+    float bucketSum;
+    uint16_t bucketCount;
+
+    // Четен = стабилно, нечетен = в момента се пише
+    std::atomic<uint32_t> sequence;
+
+    void push(uint32_t timestamp, float weight);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <Arduino.h>
+#include "ScaleManager.h"
+
+// Четенето на HX711 - отделна задача на core 1 с най-висок приоритет,
+// на точен интервал (vTaskDelayUntil), независимо колко е зает loop()
+#define SAMPLE_INTERVAL_MS     500
+#define SAMPLE_QUEUE_LENGTH    8       // 4 s проби, ако loop() е блокиран
+#define SAMPLER_TASK_CORE      1
+#define SAMPLER_TASK_PRIORITY  5
+#define SAMPLER_TASK_STACK     2560
+
+// Една проба от задачата към loop()
+struct WeightReading {
+    uint32_t timestampMs;
+    float weight;
+};
+
+class Sampler {
+public:
+    Sampler(ScaleManager& scale);
+
+    bool begin();
+    // Чака до waitMs следващата проба; false - няма проба за това време
+    bool receive(WeightReading& reading, uint32_t waitMs);
+
+private:
+    ScaleManager& scale;
+    QueueHandle_t queue;
+    TaskHandle_t taskHandle;
+    int8_t monitorId;
+
+    static void samplingTask(void* context);
+    void runTask();
+};
+
+#endif
@@ -5,6 +5,9 @@
 #include "HX711.h"
 #include <Preferences.h>
 
+// Колко чака четенето на проба, докато loop() тарира/калибрира
+#define SCALE_LOCK_WAIT_MS 20
+
 class ScaleManager {
 public:
     enum WeightUnit {
@@ -24,8 +27,13 @@ public:
     bool performCalibration(float knownWeight);
     void performTare();
     
-    // Четене
-    float getRawWeight();
+    // Неблокиращи стъпки (за фонови задачи): една проба, само ако HX711 е готов
+    bool readRawSample(long& raw);
+    void applyTare(long offset);
+    void applyCalibration(long offset, float factor);
+    
+    // Четене; NaN и когато HX711 е зает от друга задача повече от waitMs
+    float getRawWeight(uint32_t waitMs = SCALE_LOCK_WAIT_MS);
     float getWeight();
     bool isReady();
     
@@ -33,6 +41,7 @@ public:
     void setUnit(WeightUnit unit);
     WeightUnit getUnit();
     String getUnitString();
+    float convertWeight(float grams);   // g -> текущата единица
     
     // Статус
     bool isCalibrated();
@@ -41,13 +50,17 @@ public:
 private:
     HX711 scale;
     Preferences prefs;
+    // HX711 се чете от задачата за проби (Sampler), а се тарира и
+    // калибрира от loop() (бутони, web jobs) - по една операция наведнъж
+    SemaphoreHandle_t hx711Mutex;
     
     float calibrationFactor;
     long tareOffset;
     bool calibrated;
     WeightUnit currentUnit;
     
-    float convertWeight(float grams);
+    bool lock(uint32_t waitMs);
+    void unlock();
 };
 
 #endif
\ No newline at end of file
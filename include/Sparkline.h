@@ -0,0 +1,66 @@
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <stdint.h>
+
+#define SPARKLINE_COLUMNS 128      // По една колона на пиксел от екрана
+
+// Серия, намалена до ширината на екрана още при добавянето: всяка колона
+// пази min/max на пробите в своя времеви интервал. add() е O(1), а
+// рисуването чете само колоните - O(128) независимо от дължината.
+//
+// MODE_WINDOW:  плъзгащ се прозорец (напр. последните 24 ч); колоните са
+//   подравнени по време и най-старата се изхвърля, когато дойде нова.
+// MODE_SESSION: от reset() до сега; когато колоните свършат, съседните
+//   се сливат по двойки и интервалът на колона се удвоява.
+//
+// Точките трябва да идват с ненамаляващо t; по-старите се пропускат.
+class Sparkline {
+public:
+    enum Mode : uint8_t {
+        MODE_WINDOW,
+        MODE_SESSION
+    };
+
+    // WINDOW: span = целият прозорец; SESSION: span = начален интервал на колона
+    Sparkline(Mode mode, uint32_t spanSeconds);
+
+    void reset(uint32_t start = 0);
+    void add(uint32_t t, float value);
+
+    // Колона i (0 = най-лявата); false, ако няма проби в нея
+    bool column(uint8_t index, float& minValue, float& maxValue) const;
+
+    // Брой колони от началото до последната с данни (SESSION)
+    uint8_t usedColumns() const;
+
+    // Общ min/max на всички колони; false, ако серията е празна
+    bool range(float& minValue, float& maxValue) const;
+
+    bool isEmpty() const { return empty; }
+    float last() const { return lastValue; }
+
+private:
+    struct Column {
+        float minValue;
+        float maxValue;
+        bool used;
+    };
+
+    Mode mode;
+    uint32_t initialSpan;
+    uint32_t columnSpan;       // Секунди на колона
+    uint32_t origin;           // SESSION: t на колона 0
+    uint32_t headBucket;       // WINDOW: t / columnSpan на най-новата колона
+    uint8_t head;              // WINDOW: индекс на най-новата; SESSION: последната с данни
+    bool empty;
+    float lastValue;
+
+    Column columns[SPARKLINE_COLUMNS];
+
+    void clearColumn(Column& column);
+    void merge(Column& column, float minValue, float maxValue);
+    void compact();
+};
+
+#endif
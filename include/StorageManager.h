@@ -4,56 +4,98 @@
 #include <Arduino.h>
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include <atomic>
+#include "DryingTypes.h"
 
-#define MAX_DAILY_RECORDS 60  // До 60 дни история
-
-struct DailyRecord {
-    uint8_t day;
-    uint32_t timestamp;
-    float weight;
-    float lossPercent;
-    float dayChange;
-};
-
-struct DryingSession {
-    bool isActive;
-    float initialWeight;
-    float targetLossPercent;
-    uint32_t startTimestamp;
-    uint8_t currentDay;
-     uint32_t lastRecordTimestamp; 
-    
-    DailyRecord records[MAX_DAILY_RECORDS];
-    uint8_t recordCount;
-};
+// Записът на сесията/архива във флаш е в задача с най-нисък приоритет на
+// core 0 - loop() само копира сесията (~1.2 KB) и продължава
+#define STORAGE_TASK_CORE     0
+#define STORAGE_TASK_PRIORITY 1
+#define STORAGE_TASK_STACK    4096
 
 class StorageManager {
 public:
     StorageManager();
     
     bool begin();
+    // Със задачата - само заявка; чакащите записи отпадат, следващите
+    // saveSession()/archiveSession() се пишат след форматирането
     void format();
+    // Расте след всяко завършено форматиране (id-тата на архивите започват отначало)
+    uint32_t getFormatCount() const { return formatCount.load(std::memory_order_acquire); }
+    // След него saveSession()/archiveSession()/clearSession()/format() само поставят заявка
+    bool startFlushTask();
     
-    // Сесия
+    // Сесия; със задачата връщат true веднага, грешките са в лога
     bool saveSession(const DryingSession& session);
     bool loadSession(DryingSession& session);
     void clearSession();
+    // Записът във флаша веднага, в извикващата задача (задачата за запис)
+    bool writeSession(const DryingSession& session);
+    // Същото в други файлове (bench) - записаната сесия не се пипа
+    bool writeSession(const DryingSession& session, const char* sessionFile, const char* recordsFile);
+    bool loadSession(DryingSession& session, const char* sessionFile, const char* recordsFile);
+    void removeSession(const char* sessionFile, const char* recordsFile);
     
-    // Дневен запис
-    bool addDailyRecord(DryingSession& session, float weight);
+    // Архив на приключили сесии
+    bool archiveSession(const DryingSession& session);
+    uint8_t listArchives(SessionArchiveInfo* out, uint8_t maxCount);
+    bool loadArchive(uint16_t id, DryingSession& session);
     
     // Статистика
     void printFileSystem();
     size_t getUsedSpace();
     size_t getTotalSpace();
+    
+    static const uint8_t MAX_ARCHIVES = 10;   // Най-старите се трият
 
 private:
     const char* SESSION_FILE = "/session.json";
     const char* RECORDS_FILE = "/records.json";
+    const char* ARCHIVE_DIR = "/archive";
+    static const uint32_t ARCHIVE_MAGIC = 0x44525931;  // "DRY1"
+    
+    // Заглавие на архивния файл; следват recordCount записа с фиксиран размер,
+    // така че запис i е на offset sizeof(ArchiveHeader) + i * sizeof(DailyRecord)
+    struct ArchiveHeader {
+        uint32_t magic;
+        uint32_t startTimestamp;
+        float initialWeight;
+        float targetLossPercent;
+        uint8_t recordCount;
+        uint8_t currentDay;
+        uint32_t lastRecordTimestamp;
+    };
+    
+    // Заявки към задачата (пазят се със spinlock). Целият запис във флаша
+    // минава през нея - loop() не пипа LittleFS, докато задачата пише.
+    // Изпълняват се в реда FORMAT, CLEAR, SAVE, ARCHIVE; по-късна заявка
+    // отменя чакащите, които би изтрила.
+    enum FlushOp : uint8_t {
+        FLUSH_SAVE    = 0x01,
+        FLUSH_ARCHIVE = 0x02,
+        FLUSH_CLEAR   = 0x04,
+        FLUSH_FORMAT  = 0x08
+    };
+    uint8_t pendingOps;
+    DryingSession pendingSave;
+    DryingSession pendingArchive;   // Отделно - следващата сесия може да започне преди записа
+    DryingSession flushCopy;        // Работно копие на задачата
+    TaskHandle_t taskHandle;
+    int8_t monitorId;
+    std::atomic<uint32_t> formatCount;
+    
+    static void flushTask(void* context);
+    void runTask();
+    bool writeArchive(const DryingSession& session);
+    void requestOps(uint8_t ops, uint8_t cancels);
+    void formatNow();
+    void clearNow();
     
-    bool saveSessionInfo(const DryingSession& session);
-    bool saveRecords(const DryingSession& session);
-    bool loadRecords(DryingSession& session);
+    bool saveSessionInfo(const DryingSession& session, const char* path);
+    bool saveRecords(const DryingSession& session, const char* path);
+    bool loadRecords(DryingSession& session, const char* path);
+    void archivePath(uint16_t id, char* path, size_t size);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef SYSTEM_STATE_H
+#define SYSTEM_STATE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Цялото състояние, което задачите извън loop() трябва да виждат:
+// тегло, стабилност, сесия и режими. Копира се изцяло.
+struct SystemSnapshot {
+    uint32_t timestampMs;     // millis() на публикуването
+    float weight;             // Последно валидно тегло (g)
+    bool weightValid;         // false до първата проба
+    bool stable;              // Теглото не се е движило в последните проби
+
+    uint8_t operationMode;    // ButtonHandler::OperationMode
+    uint8_t displayMode;      // DisplayManager::DisplayMode
+
+    bool sessionActive;
+    float initialWeight;
+    float targetLoss;
+    float lastRecordLoss;     // Загуба (%) при последния дневен запис
+    uint8_t currentDay;
+    uint8_t recordCount;
+    int16_t daysRemaining;    // -1 = няма оценка
+    bool isReady;
+};
+
+// Snapshot зад seqlock: един писател (loop()), произволен брой читатели.
+// Писателят никога не чака; читателят повтаря копирането, ако е засякъл
+// запис, и след READ_RETRIES неуспешни опита връща false.
+class SystemState {
+public:
+    SystemState();
+
+    void publish(const SystemSnapshot& next);
+    bool read(SystemSnapshot& out) const;
+
+    // Брой публикувания - четно число, расте с 2
+    uint32_t getSequence() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    SystemSnapshot snapshot;
+    std::atomic<uint32_t> sequence;   // Нечетно = в момента се пише
+
+    static const uint8_t READ_RETRIES = 8;
+};
+
+// Стабилност по разлика max-min на последните STABILITY_WINDOW проби
+class StabilityTracker {
+public:
+    StabilityTracker();
+
+    void add(float weight);
+    void reset();
+    bool isStable() const;
+
+private:
+    static const uint8_t STABILITY_WINDOW = 4;   // 2 s при проба на 500 ms
+    static constexpr float STABILITY_RANGE = 2.0f;  // g
+
+    float window[STABILITY_WINDOW];
+    uint8_t head;
+    uint8_t count;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Metrics.h"
+
+// Задачите на фърмуера: ядро, приоритет, процесорно време и най-малко
+// свободен стек. Run-time stats на FreeRTOS са изключени в Arduino core,
+// затова всяка задача сама отчита времето, в което е работила (addBusy).
+class TaskMonitor {
+public:
+    TaskMonitor();
+
+    // Връща id за addBusy() или -1, ако регистърът е пълен
+    int8_t add(const char* name, TaskHandle_t handle, uint8_t core, uint8_t priority);
+    // Вика се само от самата задача
+    void addBusy(int8_t id, uint32_t us);
+
+    // За /metrics
+    uint8_t snapshot(MetricsTask* out, uint8_t maxCount);
+    // Таблица за "info"; заетостта е от предишното извикване насам
+    void print();
+
+private:
+    struct Entry {
+        const char* name;
+        TaskHandle_t handle;
+        uint8_t core;
+        uint8_t priority;
+        uint32_t pendingUs;              // Под 1 ms, пише само задачата
+        std::atomic<uint32_t> busyMs;
+        uint32_t printedMs;              // busyMs при предишния print()
+    };
+
+    Entry entries[METRICS_MAX_TASKS];
+    std::atomic<uint8_t> count;
+    unsigned long lastPrint;
+};
+
+// Отчита времето от създаването до края на блока
+class TaskBusy {
+public:
+    TaskBusy(int8_t id);
+    ~TaskBusy();
+
+private:
+    int8_t id;
+    unsigned long start;
+};
+
+extern TaskMonitor taskMonitor;
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Трасиране на фазите (loop(), HX711, OLED, LittleFS, HTTP) в статичен
+// ring buffer: всяка фаза пише събитие "начало" и "край" с брояча на
+// цикли, tick-а на FreeRTOS, задачата и ядрото. Запис - няколко десетки
+// цикъла, без заключване, от всяка задача. Дъмп в Chrome trace-event
+// JSON (serial "trace", GET /trace) - отваря се в chrome://tracing или
+// ui.perfetto.dev, по един ред на задача.
+//
+// Броячите на цикли на двете ядра не са синхронизирани: времената в
+// рамките на ядро са с точност до цикъл, между ядрата - до tick (1 ms).
+//
+// -DTRACE_DISABLE премахва макросите от кода.
+
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 256          // Степен на 2; 24 B на събитие
+#endif
+#define TRACE_MAX_TASKS        12
+#define TRACE_EVENT_JSON_SIZE  80   // {"name":..,"ph":"B","ts":..,"pid":1,"tid":..},
+#define TRACE_JSON_OVERHEAD    (64 + TRACE_MAX_TASKS * 80)   // Заглавие + имената на задачите
+
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0, "TRACE_CAPACITY must be a power of 2");
+
+struct TraceEvent {
+    uint32_t cycles;        // ESP.getCycleCount() на ядрото
+    uint32_t tick;          // xTaskGetTickCount() - за подравняване между ядрата
+    const char* name;       // Статичен низ
+    TaskHandle_t task;
+    std::atomic<uint32_t> sequence;   // Поредният номер; пише се последен - непълно събитие не съвпада
+    uint8_t core;
+    char phase;             // 'B' / 'E'
+};
+
+class TraceBuffer {
+public:
+    TraceBuffer();
+
+    inline void record(const char* name, char phase) {
+        if (readers.load(std::memory_order_relaxed) != 0) {
+            return;
+        }
+        uint32_t cycles = ESP.getCycleCount();
+        uint32_t sequence = head.fetch_add(1, std::memory_order_relaxed);
+        TraceEvent& event = events[sequence & (TRACE_CAPACITY - 1)];
+        event.cycles = cycles;
+        event.tick = xTaskGetTickCount();
+        event.name = name;
+        event.task = xTaskGetCurrentTaskHandle();
+        event.core = xPortGetCoreID();
+        event.phase = phase;
+        event.sequence.store(sequence, std::memory_order_release);
+    }
+
+    // Chrome trace-event JSON с последните maxEvents събития. Записът спира
+    // за времето на дъмпа; събитие, започнато точно преди това, може да е
+    // непълно - пропуска се.
+    void printJson(Print& out, uint16_t maxEvents = TRACE_CAPACITY);
+
+    // В буфер (HTTP): колкото от последните събития се събират; 0 при малък буфер
+    size_t writeJson(char* buffer, size_t size);
+
+    uint32_t getRecorded() const { return head.load(std::memory_order_relaxed); }
+    void clear();
+
+private:
+    TraceEvent events[TRACE_CAPACITY];
+    std::atomic<uint32_t> head;     // Общ брой записани събития
+    std::atomic<uint8_t> readers;   // Дъмпове в момента (serial и HTTP); >0 спира записа
+};
+
+extern TraceBuffer traceBuffer;
+
+// Начало при създаване, край в края на блока
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name) { traceBuffer.record(name, 'B'); }
+    ~TraceScope() { traceBuffer.record(name, 'E'); }
+
+private:
+    const char* name;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifndef TRACE_DISABLE
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_BEGIN(name) traceBuffer.record(name, 'B')
+#define TRACE_END(name)   traceBuffer.record(name, 'E')
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_BEGIN(name) do {} while (0)
+#define TRACE_END(name)   do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef UI_CONTROLLER_H
+#define UI_CONTROLLER_H
+
+#include <Arduino.h>
+#include "ScaleManager.h"
+#include "DryingSessionManager.h"
+#include "DisplayManager.h"
+#include "ButtonHandler.h"
+#include "Sparkline.h"
+
+// Какво показва OLED-ът между натисканията: временни съобщения,
+// периодичното обновяване на екрана по режим, графиките и автоматичния
+// дневен запис. Вика се от loop() (и от host runner-а bench/ui_replay.cpp).
+class UiController {
+public:
+    UiController(DisplayManager& display, ButtonHandler& buttons,
+                 DryingSessionManager& drying, ScaleManager& scale);
+
+    // Съобщение за MESSAGE_DISPLAY_DURATION, после екранът се връща
+    void showMessage(const char* title, const char* message);
+    void applyRequests(uint8_t requests);   // ButtonHandler::UiRequest
+    void forceRedraw();
+
+    // Нова проба от кантара (графиките)
+    void addSample(uint32_t timestamp, float weight);
+
+    // Изтичане на съобщението, дневен запис и обновяване на екрана.
+    // displayBusy - дисплеят е зает от друг (web калибрация)
+    void update(float currentWeight, bool displayBusy);
+
+    bool isShowingMessage() const { return showingMessage; }
+
+private:
+    DisplayManager& display;
+    ButtonHandler& buttons;
+    DryingSessionManager& drying;
+    ScaleManager& scale;
+
+    unsigned long lastDisplayUpdate;
+    unsigned long messageDisplayTime;
+    float lastDisplayedWeight;
+    bool showingMessage;
+
+    Sparkline dayGraph;            // Тегло за последните 24 ч
+    Sparkline lossGraph;           // Загуба от началото на сесията
+    uint32_t lossGraphSession;     // startTimestamp на сесията в lossGraph
+    uint32_t lossGraphOffset;      // Времената са uptime - след рестарт продължават след записите
+
+    const unsigned long DISPLAY_UPDATE_INTERVAL = 500;
+    const unsigned long MESSAGE_DISPLAY_DURATION = 2000;
+    const float DISPLAY_UPDATE_THRESHOLD = 1.0f;
+    const uint32_t DAILY_RECORD_INTERVAL = 86400;   // 24 часа
+
+    void recordIfDue(float currentWeight);
+    void refreshScreen(float currentWeight);
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef WEB_API_H
+#define WEB_API_H
+
+#include "JsonWriter.h"
+#include "DryingTypes.h"
+#include "Downsampler.h"
+
+// JSON отговорите на web API-то. Без Arduino зависимости и без heap -
+// пишат директно в буфера на JsonWriter, компилират се и на host.
+
+// Копие на състоянието, от което четат HTTP handler-ите
+struct StatusSnapshot {
+    bool active;
+    float initialWeight;
+    float currentWeight;
+    float targetLoss;
+    uint8_t currentDay;
+    uint8_t recordCount;
+    int daysRemaining;
+    bool isReady;
+};
+
+// Еднакво ли е съдържанието на /status/data за двата snapshot-а
+bool sameStatus(const StatusSnapshot& a, const StatusSnapshot& b);
+
+// Загуба (%) спрямо текущото тегло, не спрямо последния дневен запис
+float realtimeLossPercent(float initialWeight, float currentWeight);
+
+// /status/data
+void writeStatusJson(JsonWriter& json, const StatusSnapshot& snap);
+
+// Полета на запис в /history/data (?fields=day,ts,weight,loss,change)
+enum HistoryField : uint8_t {
+    FIELD_DAY    = 0x01,
+    FIELD_TS     = 0x02,
+    FIELD_WEIGHT = 0x04,
+    FIELD_LOSS   = 0x08,
+    FIELD_CHANGE = 0x10,
+    FIELD_DEFAULT = FIELD_DAY | FIELD_WEIGHT | FIELD_LOSS | FIELD_CHANGE
+};
+
+// Параметри на /history/data
+struct HistoryQuery {
+    int32_t since;       // Първи индекс (-1 = от началото)
+    uint32_t sinceTs;    // Само записи с timestamp > sinceTs
+    uint32_t from;       // timestamp >= from
+    uint32_t to;         // timestamp <= to
+    uint16_t limit;      // 0 = без ограничение
+    uint8_t fields;
+    bool hasSinceTs;
+    bool hasFrom;
+    bool hasTo;
+
+    HistoryQuery()
+        : since(-1), sinceTs(0), from(0), to(0), limit(0), fields(FIELD_DEFAULT),
+          hasSinceTs(false), hasFrom(false), hasTo(false) {}
+};
+
+// Еднакви параметри -> еднакъв отговор (за кеша)
+bool sameHistoryQuery(const HistoryQuery& a, const HistoryQuery& b);
+
+// Записите се добавят хронологично, но timestamp-ът е от millis() и
+// започва отначало след рестарт. Двоично търсене само ако са подредени.
+bool timestampsSorted(const DailyRecord* records, uint8_t count);
+
+// "day,weight" -> маска; 0 при непознато поле
+uint8_t parseHistoryFields(const char* list);
+
+// Диапазон [first, last) от записи според заявката
+void resolveHistoryRange(const DailyRecord* records, uint8_t count, bool sorted,
+                         const HistoryQuery& query, uint8_t& first, uint8_t& last);
+
+// /history/data
+// archiveId = 0 за текущата сесия. "next" е индексът за следващото ?since=.
+void writeHistoryJson(JsonWriter& json, bool active, uint16_t archiveId, uint32_t sessionStart,
+                      const DailyRecord* records, uint8_t count, bool sorted,
+                      const HistoryQuery& query);
+
+// /history/sessions
+void writeSessionListJson(JsonWriter& json, const SessionArchiveInfo* sessions, uint8_t count);
+
+#define SERIES_DEFAULT_POINTS 200
+#define SERIES_MAX_POINTS     500
+#define SERIES_POINT_JSON_SIZE 24   // "[4294967295,-12345.6],"
+
+// Параметри на /series
+struct SeriesQuery {
+    uint32_t from;       // timestamp >= from (по подразбиране - първата точка)
+    uint32_t to;         // timestamp <= to (по подразбиране - последната)
+    uint16_t points;
+    Downsampler::Mode mode;
+    bool hasFrom;
+    bool hasTo;
+
+    SeriesQuery()
+        : from(0), to(0), points(SERIES_DEFAULT_POINTS), mode(Downsampler::MODE_LTTB),
+          hasFrom(false), hasTo(false) {}
+};
+
+// Чете точка i (0 = най-старата) от източника на серията
+typedef void (*SeriesReadFn)(void* context, uint16_t index, uint32_t& t, float& value);
+
+// "lttb" / "minmax"; false при непознат режим
+bool parseSeriesMode(const char* name, Downsampler::Mode& mode);
+
+// /series - източникът се чете еднократно, последователно, през Downsampler.
+// Размерът на отговора зависи само от query.points, не от count.
+void writeSeriesJson(JsonWriter& json, const char* source, const SeriesQuery& query,
+                     uint16_t count, SeriesReadFn read, void* context);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// Предварително компресирана (gzip) статична страница в flash.
+// Данните се генерират от scripts/build_web_assets.py в src/WebAssets.cpp.
+struct WebAsset {
+    const uint8_t* data;
+    size_t length;
+    const char* etag;          // Силен ETag, с кавичките
+    const char* contentType;
+};
+
+extern const WebAsset WEB_ASSET_MONITOR;
+extern const WebAsset WEB_ASSET_HISTORY;
+
+#endif
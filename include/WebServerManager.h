@@ -2,36 +2,102 @@
 #define WEB_SERVER_MANAGER_H
 
 #include <Arduino.h>
-#include <WebServer.h>
 #include <WiFi.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
 #include "DryingSessionManager.h"
+#include "StorageManager.h"
+#include "SampleLog.h"
+#include "SystemState.h"
+#include "JobManager.h"
+#include "WebAssets.h"
+#include "ApiHandler.h"
+#include "Metrics.h"
 
 class WebServerManager {
 public:
     WebServerManager();
+
+    void init(StorageManager* storageMgr, SampleLog* samples);
     
-    void init(DryingSessionManager* dryingMgr, float* currentWeightPtr);
-    bool begin(const char* ssid, const char* password);
-    void handle();
-    bool isConnected();
-    String getIPAddress();
-    
+    // POST /api/* - без token (празен низ) управлението е изключено
+    void enableControl(JobManager* jobManager, const char* token);
+
+    // Пуска HTTP сървъра (след първия IP от NetworkManager)
+    void begin();
+    bool isStarted() { return serverStarted; }
+
+    // Извиква се от loop() - публикува snapshot за HTTP задачата
+    void publish(const SystemState& state, DryingSessionManager& drying);
+
+    // Расте при всяка промяна на сесията, записите или филтрираното тегло
+    uint32_t getGeneration() const { return api.getGeneration(); }
+
+    // След форматиране на LittleFS (id-тата на архивите започват отначало)
+    void invalidateArchives() { api.invalidateArchives(); }
+
 private:
-    WebServer server;
-    DryingSessionManager* dryingPtr;
-    float* currentWeightPtr;
+    AsyncWebServer server;
+    AsyncEventSource events;
+    bool serverStarted;
+
+    // Snapshot-и, кеш по поколение, ETag-ове и JSON на /status/data,
+    // /history/data и /series - тук е само HTTP обвивката
+    ApiHandler api;
+
+    // Архивите се четат от LittleFS в async_tcp задачата
+    StorageManager* storagePtr;
     
+    // Управление - операциите се изпълняват от loop() като задачи
+    JobManager* jobsPtr;
+    const char* apiToken;
+
+    // Ограничение на едновременните заявки (handler-ите вървят в async_tcp задачата)
+    uint8_t activeRequests;
+    const uint8_t MAX_CONCURRENT_REQUESTS = 4;
+    const uint32_t REQUEST_RX_TIMEOUT_SEC = 5;
+    const uint32_t REQUEST_ACK_TIMEOUT_MS = 5000;
+
+    // Push (SSE) - делти само при реална промяна. Целият SSE трафик е в
+    // async_tcp задачата (ESPAsyncWebServer не пази списъка с клиенти):
+    // loop() само публикува статуса в api, а poll-ът на всеки SSE клиент
+    // (~500 ms) сравнява с изпратеното и праща делтата на всички.
+    StatusSnapshot lastPushed;
+    bool hasPushed;
+    uint32_t pushedGeneration;
+    uint32_t eventSeq;
+    unsigned long lastPushTime;
+    const unsigned long PUSH_MIN_INTERVAL = 500;
+    const size_t MAX_EVENT_CLIENTS = 4;
+    const float PUSH_WEIGHT_THRESHOLD = 1.0f;  // Като при дисплея
+
     void setupRoutes();
-    
-    // Handler функции (като в работещия код)
-    void handleMonitorPage();
-    void handleHistoryPage();
-    void handleStatusData();
-    void handleHistoryData();
-    
-    // Helper функции
-    String getStatusJSON();
-    String getHistoryJSON();
+    void handleTimed(HttpRoute route, AsyncWebServerRequest* request,
+                     void (WebServerManager::*handler)(AsyncWebServerRequest*));
+    bool admitRequest(AsyncWebServerRequest* request);
+    const char* ifNoneMatch(AsyncWebServerRequest* request);
+    bool notModified(AsyncWebServerRequest* request, const char* etag);
+    void sendJson(AsyncWebServerRequest* request, int code, const char* json, const char* etag = nullptr);
+    void sendAsset(AsyncWebServerRequest* request, const WebAsset& asset);
+    void handleApi(AsyncWebServerRequest* request, ApiRoute route);
+    bool getQuery(AsyncWebServerRequest* request, char* out, size_t size);
+    void pollEvents(AsyncEventSourceClient* client);
+    void pushChanges();
+    static bool loadArchive(void* context, uint16_t id, DryingSession& session);
+
+    // Handler функции
+    void handleMonitorPage(AsyncWebServerRequest* request);
+    void handleHistoryPage(AsyncWebServerRequest* request);
+    void handleStatusData(AsyncWebServerRequest* request);
+    void handleHistoryData(AsyncWebServerRequest* request);
+    void handleSessionList(AsyncWebServerRequest* request);
+    void handleSeries(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
+    void handleTrace(AsyncWebServerRequest* request);
+    void handleControl(AsyncWebServerRequest* request, JobManager::JobType type);
+    void handleJobStatus(AsyncWebServerRequest* request);
+    bool authorize(AsyncWebServerRequest* request);
+    bool getFloatParam(AsyncWebServerRequest* request, const char* name, float& value);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,97 @@
+"""
+Build step за web страниците.
+
+Минифицира web/*.html, компресира ги с gzip и генерира src/WebAssets.cpp
+с масиви в flash и ETag (SHA-256 на компресираното съдържание).
+
+PlatformIO го пуска преди всеки build (extra_scripts = pre:...).
+Може да се пусне и ръчно: python scripts/build_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 - SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "WebAssets.cpp")
+
+# (файл, име на символа, content type)
+ASSETS = [
+    ("monitor.html", "WEB_ASSET_MONITOR", "text/html"),
+    ("history.html", "WEB_ASSET_HISTORY", "text/html"),
+]
+
+
+def minify(text):
+    # Консервативно: маха отстъпи, празни редове, HTML коментари и
+    # JS редове, които са само коментар. Новите редове остават (ASI в JS).
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith("//"):
+            continue
+        lines.append(line)
+    return "\n".join(lines) + "\n"
+
+
+def c_array(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def build():
+    parts = [
+        "// Генериран от scripts/build_web_assets.py - не редактирай ръчно.",
+        "// Източник: web/*.html",
+        "",
+        '#include "WebAssets.h"',
+        "",
+    ]
+
+    for filename, symbol, content_type in ASSETS:
+        with open(os.path.join(WEB_DIR, filename), "r", encoding="utf-8") as f:
+            source = f.read()
+
+        minified = minify(source).encode("utf-8")
+        # mtime=0 - еднакъв изход при еднакъв вход
+        compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(compressed).hexdigest()[:16]
+
+        parts.append("// %s: %d -> %d -> %d bytes" % (
+            filename, len(source.encode("utf-8")), len(minified), len(compressed)))
+        parts.append("static const uint8_t %s_DATA[] PROGMEM = {" % symbol)
+        parts.append(c_array(compressed))
+        parts.append("};")
+        parts.append("")
+        parts.append("const WebAsset %s = {" % symbol)
+        parts.append("    %s_DATA," % symbol)
+        parts.append("    sizeof(%s_DATA)," % symbol)
+        parts.append('    "\\"%s\\"",' % etag)
+        parts.append('    "%s"' % content_type)
+        parts.append("};")
+        parts.append("")
+
+    output = "\n".join(parts)
+
+    # Записваме само при промяна, за да не се прекомпилира излишно
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            if f.read() == output:
+                return
+
+    with open(OUTPUT, "w", encoding="utf-8") as f:
+        f.write(output)
+    print("[web] Generated %s" % os.path.relpath(OUTPUT, PROJECT_DIR))
+
+
+build()
@@ -0,0 +1,337 @@
+#include "AlertManager.h"
+#include <HTTPClient.h>
+#include "EventBus.h"
+
+// Опашката на webhook-ите: пълни се от loop(), изпразва се от задачата на мрежата
+static portMUX_TYPE webhookMux = portMUX_INITIALIZER_UNLOCKED;
+
+AlertManager::AlertManager(int8_t buzzerPin) {
+    this->buzzerPin = buzzerPin;
+    buzzerOffAt = 0;
+    ruleCount = 0;
+    webhookUrl = nullptr;
+    webhookHead = 0;
+    webhookCount = 0;
+    lastWebhook = 0;
+    bannerTitle[0] = '\0';
+    bannerMessage[0] = '\0';
+    bannerPending = false;
+    filterHead = 0;
+    filterCount = 0;
+    fireCount = 0;
+}
+
+void AlertManager::begin(const RuleConfig* config, uint8_t count, const char* url) {
+    if (buzzerPin >= 0) {
+        pinMode(buzzerPin, OUTPUT);
+        digitalWrite(buzzerPin, LOW);
+    }
+
+    webhookUrl = (url && url[0] != '\0') ? url : nullptr;
+
+    // Компилиране на правилата в компактна таблица
+    ruleCount = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (ruleCount >= MAX_ALERT_RULES) {
+            Serial.println("[Alerts] Too many rules, ignoring the rest");
+            break;
+        }
+
+        const RuleConfig& c = config[i];
+        if (c.type == ALERT_STALL && c.windowSec == 0) {
+            Serial.printf("[Alerts] Rule '%s' has no window, skipped\n", c.name);
+            continue;
+        }
+
+        Rule& rule = rules[ruleCount++];
+        rule.name = c.name;
+        rule.type = c.type;
+        rule.value = c.value;
+        rule.windowMs = c.windowSec * 1000UL;
+        rule.actions = webhookUrl ? c.actions : (c.actions & ~ACTION_WEBHOOK);
+        rule.debounceMs = c.debounceMs;
+        rule.minIntervalMs = c.minIntervalMs;
+        rule.conditionSince = 0;
+        rule.lastFired = 0;
+        rule.refWeight = NAN;
+        rule.refTime = 0;
+        rule.latched = false;
+    }
+
+    Serial.printf("[Alerts] %d rules loaded, webhook: %s\n",
+                  ruleCount, webhookUrl ? "ON" : "OFF");
+}
+
+void AlertManager::evaluate(DryingSessionManager& drying, float currentWeight) {
+    if (isnan(currentWeight)) {
+        return;
+    }
+
+    if (!drying.isActive()) {
+        // Извън сесия няма какво да следим - нулираме състоянието
+        for (uint8_t i = 0; i < ruleCount; i++) {
+            rules[i].conditionSince = 0;
+            rules[i].latched = false;
+            rules[i].refWeight = NAN;
+        }
+        filterCount = 0;
+        return;
+    }
+
+    // Общите входни данни се изчисляват веднъж - всяко правило е O(1)
+    DryingSession& session = drying.getSession();
+    float lossPercent = 0.0f;
+    if (session.initialWeight > 0) {
+        lossPercent = (session.initialWeight - currentWeight) / session.initialWeight * 100.0f;
+    }
+    float dailyRate = drying.getAverageDailyLoss();
+    bool ready = drying.isReady();
+    uint32_t now = millis();
+    float filtered = filterWeight(currentWeight);
+
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        Rule& rule = rules[i];
+        float value = 0.0f;
+        float weight = rule.type == ALERT_ANOMALY ? filtered : currentWeight;
+
+        if (!checkCondition(rule, weight, lossPercent, dailyRate, ready, now, value)) {
+            rule.conditionSince = 0;
+            rule.latched = false;
+            continue;
+        }
+
+        // Debounce - условието трябва да се задържи
+        if (rule.conditionSince == 0) {
+            rule.conditionSince = now;
+        }
+        if (rule.latched || now - rule.conditionSince < rule.debounceMs) {
+            continue;
+        }
+
+        // Rate limit на правилото
+        if (rule.lastFired != 0 && now - rule.lastFired < rule.minIntervalMs) {
+            continue;
+        }
+
+        rule.latched = true;
+        fire(i, value, weight, now);
+    }
+}
+
+// NAN, докато прозорецът не се напълни
+float AlertManager::filterWeight(float weight) {
+    filterWindow[filterHead] = weight;
+    filterHead = (filterHead + 1) % ANOMALY_FILTER_SIZE;
+    if (filterCount < ANOMALY_FILTER_SIZE) {
+        filterCount++;
+        if (filterCount < ANOMALY_FILTER_SIZE) {
+            return NAN;
+        }
+    }
+
+    float sorted[ANOMALY_FILTER_SIZE];
+    memcpy(sorted, filterWindow, sizeof(sorted));
+    for (uint8_t i = 1; i < ANOMALY_FILTER_SIZE; i++) {
+        float v = sorted[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[ANOMALY_FILTER_SIZE / 2];
+}
+
+bool AlertManager::checkCondition(Rule& rule, float weight, float lossPercent, float dailyRate,
+                                  bool ready, uint32_t now, float& value) {
+    switch (rule.type) {
+        case ALERT_THRESHOLD:
+            value = lossPercent;
+            return lossPercent >= rule.value;
+
+        case ALERT_RATE:
+            value = dailyRate;
+            return dailyRate >= rule.value;
+
+        case ALERT_STALL:
+            // Референтното тегло се мести при всяка промяна над прага
+            if (isnan(rule.refWeight) || abs(weight - rule.refWeight) > rule.value) {
+                rule.refWeight = weight;
+                rule.refTime = now;
+                return false;
+            }
+            value = (now - rule.refTime) / 1000.0f;
+            return now - rule.refTime >= rule.windowMs;
+
+        case ALERT_ANOMALY:
+            // Като ALERT_STALL, но обратно: отместването над ±value от
+            // референцията трябва да се задържи debounceMs. В прага
+            // референцията следва теглото с времеконстанта debounceMs -
+            // съхненето се проследява, а отворена врата за минути почти не
+            // я мести и връщането не е "скок"
+            if (isnan(weight)) {
+                return false;
+            }
+            if (isnan(rule.refWeight)) {
+                rule.refWeight = weight;
+                rule.refTime = now;
+                return false;
+            }
+            {
+                uint32_t elapsed = now - rule.refTime;
+                rule.refTime = now;
+                value = weight - rule.refWeight;
+                if (abs(value) > rule.value) {
+                    return true;
+                }
+                rule.refWeight += rule.debounceMs > 0 ? value * elapsed / (float)(rule.debounceMs + elapsed) : value;
+            }
+            return false;
+
+        case ALERT_READY:
+            value = lossPercent;
+            return ready;
+
+        default:
+            return false;
+    }
+}
+
+void AlertManager::fire(uint8_t index, float value, float weight, uint32_t now) {
+    Rule& rule = rules[index];
+    rule.lastFired = now;
+    fireCount++;
+
+    Serial.printf("[Alerts] '%s' fired: value=%.1f, weight=%.1fg\n", rule.name, value, weight);
+
+    if (rule.type == ALERT_ANOMALY) {
+        // Новото ниво става референция - следващ скок се мери от него
+        rule.refWeight = weight;
+        rule.refTime = now;
+        AnomalyDetectedEvent event = { rule.name, value, weight };
+        EventBus::publish(event);
+    }
+
+    if (rule.actions & ACTION_BANNER) {
+        snprintf(bannerTitle, sizeof(bannerTitle), "ALERT");
+        switch (rule.type) {
+            case ALERT_READY:
+                snprintf(bannerMessage, sizeof(bannerMessage), "READY -%.1f%%", value);
+                break;
+            case ALERT_THRESHOLD:
+                snprintf(bannerMessage, sizeof(bannerMessage), "Loss -%.1f%%", value);
+                break;
+            case ALERT_RATE:
+                snprintf(bannerMessage, sizeof(bannerMessage), "Fast %.1f%%/day", value);
+                break;
+            case ALERT_STALL:
+                snprintf(bannerMessage, sizeof(bannerMessage), "No loss %luh",
+                         (unsigned long)(value / 3600.0f));
+                break;
+            case ALERT_ANOMALY:
+                snprintf(bannerMessage, sizeof(bannerMessage), "Jump %+.0fg", value);
+                break;
+            default:
+                snprintf(bannerMessage, sizeof(bannerMessage), "%s", rule.name);
+                break;
+        }
+        bannerPending = true;
+    }
+
+    if ((rule.actions & ACTION_BUZZER) && buzzerPin >= 0) {
+        digitalWrite(buzzerPin, HIGH);
+        buzzerOffAt = millis() + BUZZER_PULSE_MS;
+    }
+
+    if (rule.actions & ACTION_WEBHOOK) {
+        portENTER_CRITICAL(&webhookMux);
+        bool queued = webhookCount < MAX_PENDING_WEBHOOKS;
+        if (queued) {
+            uint8_t slot = (webhookHead + webhookCount) % MAX_PENDING_WEBHOOKS;
+            webhooks[slot].ruleIndex = index;
+            webhooks[slot].value = value;
+            webhooks[slot].weight = weight;
+            webhookCount++;
+        }
+        portEXIT_CRITICAL(&webhookMux);
+
+        if (!queued) {
+            Serial.println("[Alerts] Webhook queue full, dropped");
+        }
+    }
+}
+
+void AlertManager::update() {
+    unsigned long now = millis();
+
+    if (buzzerOffAt != 0 && (long)(now - buzzerOffAt) >= 0) {
+        digitalWrite(buzzerPin, LOW);
+        buzzerOffAt = 0;
+    }
+}
+
+void AlertManager::webhookWork(void* context) {
+    static_cast<AlertManager*>(context)->sendPendingWebhook();
+}
+
+void AlertManager::sendPendingWebhook() {
+    unsigned long now = millis();
+    if (!webhookUrl) {
+        return;
+    }
+    if (lastWebhook != 0 && now - lastWebhook < WEBHOOK_MIN_INTERVAL) {
+        return;
+    }
+
+    // Копие извън заключването - POST-ът е бавен
+    portENTER_CRITICAL(&webhookMux);
+    bool pending = webhookCount > 0;
+    Webhook hook;
+    if (pending) {
+        hook = webhooks[webhookHead];
+        webhookHead = (webhookHead + 1) % MAX_PENDING_WEBHOOKS;
+        webhookCount--;
+    }
+    portEXIT_CRITICAL(&webhookMux);
+
+    if (!pending) {
+        return;
+    }
+    lastWebhook = now;
+    sendWebhook(hook);
+}
+
+void AlertManager::sendWebhook(const Webhook& hook) {
+    char body[128];
+    snprintf(body, sizeof(body), "{\"rule\":\"%s\",\"value\":%.1f,\"weight\":%.1f}",
+             rules[hook.ruleIndex].name, hook.value, hook.weight);
+
+    HTTPClient http;
+    http.setTimeout(2000);
+    http.setConnectTimeout(2000);
+
+    if (!http.begin(webhookUrl)) {
+        Serial.println("[Alerts] Webhook URL invalid");
+        return;
+    }
+
+    http.addHeader("Content-Type", "application/json");
+    int code = http.POST((uint8_t*)body, strlen(body));
+    http.end();
+
+    if (code < 200 || code >= 300) {
+        Serial.printf("[Alerts] Webhook failed: %d\n", code);
+    }
+}
+
+bool AlertManager::popBanner(char* title, size_t titleSize, char* message, size_t messageSize) {
+    if (!bannerPending) {
+        return false;
+    }
+
+    snprintf(title, titleSize, "%s", bannerTitle);
+    snprintf(message, messageSize, "%s", bannerMessage);
+    bannerPending = false;
+    return true;
+}
@@ -0,0 +1,429 @@
+#include "ApiHandler.h"
+#include "JsonWriter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ApiHandler::ApiHandler() : generation(1), archiveEpoch(0), statusSequence(0), recordsSequence(0) {
+    bootId = 0;
+    memset(&status, 0, sizeof(status));
+    recordCount = 0;
+    recordsActive = false;
+    recordsSessionStart = 0;
+    recordsSorted = true;
+    samples = nullptr;
+    loadArchive = nullptr;
+    archiveContext = nullptr;
+    statusJson[0] = '\0';
+    statusJsonValid = false;
+    statusJsonGeneration = 0;
+    historyJson[0] = '\0';
+    historyJsonValid = false;
+    historyJsonGeneration = 0;
+    historyJsonArchive = 0;
+    historyJsonEpoch = 0;
+    bulkBuffer[0] = '\0';
+}
+
+void ApiHandler::begin(uint32_t bootId, SampleLog* samples, ArchiveLoadFn loadArchive, void* archiveContext) {
+    this->bootId = bootId;
+    this->samples = samples;
+    this->loadArchive = loadArchive;
+    this->archiveContext = archiveContext;
+}
+
+// ============= loop() =============
+
+void ApiHandler::publishStatus(StatusSnapshot& next) {
+    // status се пише само от тази задача, затова се чете без seqlock
+    if (next.active && status.active &&
+        fabsf(next.currentWeight - status.currentWeight) < WEIGHT_FILTER_THRESHOLD) {
+        next.currentWeight = status.currentWeight;
+    }
+    if (sameStatus(next, status)) {
+        return;
+    }
+
+    statusSequence.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+    status = next;
+    statusSequence.fetch_add(1, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+void ApiHandler::publishRecords(const DailyRecord* source, uint8_t count, bool active, uint32_t sessionStart) {
+    if (count == recordCount && active == recordsActive && sessionStart == recordsSessionStart) {
+        return;
+    }
+
+    recordsSequence.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(records, source, sizeof(DailyRecord) * count);
+    recordCount = count;
+    recordsActive = active;
+    recordsSessionStart = sessionStart;
+    recordsSorted = timestampsSorted(records, count);
+    recordsSequence.fetch_add(1, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+void ApiHandler::invalidateArchives() {
+    archiveEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ============= Задачата на HTTP =============
+
+void ApiHandler::fail(ApiResponse& out, int code, const char* body) const {
+    out.code = code;
+    out.etag[0] = '\0';
+    out.body = body;
+}
+
+void ApiHandler::handle(ApiRoute route, const char* query, const char* ifNoneMatch, ApiResponse& out) {
+    out.code = 200;
+    out.etag[0] = '\0';
+    out.body = "";
+
+    switch (route) {
+        case API_STATUS: {
+            // Непроменено състояние - едно сравнение и 304
+            uint32_t current = getGeneration();
+            if (checkEtag(current, ifNoneMatch, out)) return;
+            const char* json = getStatusJSON(current);
+            if (json != statusJson) {
+                fail(out, 503, json);
+                return;
+            }
+            out.body = json;
+            return;
+        }
+        case API_HISTORY:
+            handleHistory(query, ifNoneMatch, out);
+            return;
+        case API_SERIES:
+            handleSeries(query, ifNoneMatch, out);
+            return;
+    }
+    fail(out, 404, "{\"error\":\"Not found\"}");
+}
+
+bool ApiHandler::checkEtag(uint32_t version, const char* ifNoneMatch, ApiResponse& out) const {
+    snprintf(out.etag, sizeof(out.etag), "\"%08x-%x\"", (unsigned)bootId, (unsigned)version);
+    return matchEtag(ifNoneMatch, out);
+}
+
+// Архивът не се променя след записа, а id-тата растат до форматиране
+// (invalidateArchives) - ETag-ът е на архива, не на поколението
+bool ApiHandler::checkArchiveEtag(uint16_t archiveId, const char* ifNoneMatch, ApiResponse& out) const {
+    snprintf(out.etag, sizeof(out.etag), "\"%08x-a%u.%u\"", (unsigned)bootId,
+             (unsigned)archiveEpoch.load(std::memory_order_relaxed), (unsigned)archiveId);
+    return matchEtag(ifNoneMatch, out);
+}
+
+bool ApiHandler::matchEtag(const char* ifNoneMatch, ApiResponse& out) const {
+    // Браузърът вече има тази версия - само 304, без тяло
+    if (ifNoneMatch[0] == '\0' || strstr(ifNoneMatch, out.etag) == nullptr) {
+        return false;
+    }
+    out.code = 304;
+    out.body = "";
+    return true;
+}
+
+bool ApiHandler::readStatus(StatusSnapshot& out) const {
+    for (uint8_t attempt = 0; attempt < API_READ_RETRIES; attempt++) {
+        uint32_t token = statusSequence.load(std::memory_order_acquire);
+        out = status;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((token & 1) == 0 && statusSequence.load(std::memory_order_relaxed) == token) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Кешът е валиден, докато поколението не се смени
+const char* ApiHandler::getStatusJSON(uint32_t forGeneration) {
+    if (statusJsonValid && statusJsonGeneration == forGeneration) {
+        return statusJson;
+    }
+
+    // Поколението е прочетено преди snapshot-а, така че данните са поне
+    // толкова нови - в най-лошия случай следващата заявка генерира отново
+    StatusSnapshot snap;
+    if (!readStatus(snap)) {
+        return "{\"error\":\"Busy\"}";
+    }
+    JsonWriter json(statusJson, sizeof(statusJson));
+    writeStatusJson(json, snap);
+
+    statusJsonGeneration = forGeneration;
+    statusJsonValid = true;
+    return statusJson;
+}
+
+void ApiHandler::handleHistory(const char* query, const char* ifNoneMatch, ApiResponse& out) {
+    HistoryQuery historyQuery;
+    uint16_t archiveId = 0;
+    if (!parseHistoryQuery(query, historyQuery, archiveId)) {
+        fail(out, 400, "{\"error\":\"Bad query\"}");
+        return;
+    }
+
+    // Архивите не се променят, а текущата сесия - само с поколението
+    uint32_t current = getGeneration();
+    uint32_t epoch = archiveEpoch.load(std::memory_order_relaxed);
+    if (archiveId > 0 ? checkArchiveEtag(archiveId, ifNoneMatch, out)
+                      : checkEtag(current, ifNoneMatch, out)) {
+        return;
+    }
+
+    if (historyJsonValid && historyJsonArchive == archiveId &&
+        (archiveId > 0 ? historyJsonEpoch == epoch : historyJsonGeneration == current) &&
+        sameHistoryQuery(historyJsonQuery, historyQuery)) {
+        out.body = historyJson;
+        return;
+    }
+    historyJsonValid = false;
+    if (!writeHistory(historyQuery, archiveId, out)) {
+        return;
+    }
+
+    historyJsonValid = true;
+    historyJsonGeneration = current;
+    historyJsonQuery = historyQuery;
+    historyJsonArchive = archiveId;
+    historyJsonEpoch = epoch;
+    out.body = historyJson;
+}
+
+bool ApiHandler::writeHistory(const HistoryQuery& query, uint16_t archiveId, ApiResponse& out) {
+    if (archiveId > 0) {
+        // Приключила сесия от архива
+        if (!loadArchive || !loadArchive(archiveContext, archiveId, archiveBuffer)) {
+            fail(out, 404, "{\"error\":\"Not found\"}");
+            return false;
+        }
+        JsonWriter json(historyJson, sizeof(historyJson));
+        writeHistoryJson(json, false, archiveId, archiveBuffer.startTimestamp,
+                         archiveBuffer.records, archiveBuffer.recordCount,
+                         timestampsSorted(archiveBuffer.records, archiveBuffer.recordCount), query);
+        if (json.overflowed()) {
+            fail(out, 500, "{\"error\":\"Too large\"}");
+            return false;
+        }
+        return true;
+    }
+
+    // Записите на последната сесия остават достъпни и след края ѝ.
+    // Ако loop() ги е сменил по време на четенето - отначало.
+    for (uint8_t attempt = 0; attempt < API_READ_RETRIES; attempt++) {
+        uint32_t token = recordsSequence.load(std::memory_order_acquire);
+        JsonWriter json(historyJson, sizeof(historyJson));
+        writeHistoryJson(json, recordsActive, 0, recordsSessionStart,
+                         records, recordCount, recordsSorted, query);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ((token & 1) == 0 && recordsSequence.load(std::memory_order_relaxed) == token) {
+            if (json.overflowed()) {
+                fail(out, 500, "{\"error\":\"Too large\"}");
+                return false;
+            }
+            return true;
+        }
+    }
+    fail(out, 503, "{\"error\":\"Busy\"}");
+    return false;
+}
+
+void ApiHandler::handleSeries(const char* query, const char* ifNoneMatch, ApiResponse& out) {
+    SeriesQuery seriesQuery;
+    uint16_t archiveId = 0;
+    bool fromRecords = false;
+    if (!parseSeriesQuery(query, seriesQuery, archiveId, fromRecords)) {
+        fail(out, 400, "{\"error\":\"Bad query\"}");
+        return;
+    }
+
+    // Версията е поколението за записите и брояча на лога за пробите;
+    // архивът има собствен, постоянен ETag
+    if (fromRecords && archiveId > 0) {
+        if (checkArchiveEtag(archiveId, ifNoneMatch, out)) return;
+    } else {
+        uint32_t version = fromRecords ? getGeneration() : (samples ? samples->beginRead() : 0);
+        if (checkEtag(version, ifNoneMatch, out)) return;
+    }
+
+    bool ok = fromRecords ? writeRecordSeries(seriesQuery, archiveId, out)
+                          : writeSampleSeries(seriesQuery, out);
+    if (ok) {
+        out.body = bulkBuffer;
+    }
+}
+
+static void readSample(void* context, uint16_t index, uint32_t& t, float& value) {
+    WeightSample sample = static_cast<SampleLog*>(context)->at(index);
+    t = sample.timestamp;
+    value = sample.weight;
+}
+
+static void readRecord(void* context, uint16_t index, uint32_t& t, float& value) {
+    const DailyRecord& record = static_cast<const DailyRecord*>(context)[index];
+    t = record.timestamp;
+    value = record.weight;
+}
+
+bool ApiHandler::writeSampleSeries(const SeriesQuery& query, ApiResponse& out) {
+    if (!samples) {
+        fail(out, 503, "{\"error\":\"No samples\"}");
+        return false;
+    }
+
+    // Без заключване: ако loop() е добавил проба по време на четенето,
+    // резултатът се изхвърля и се чете отново (записът е веднъж в минута)
+    for (uint8_t attempt = 0; attempt < API_READ_RETRIES; attempt++) {
+        uint32_t token = samples->beginRead();
+        JsonWriter json(bulkBuffer, sizeof(bulkBuffer));
+        writeSeriesJson(json, "samples", query, samples->size(), readSample, samples);
+
+        if (samples->endRead(token)) {
+            if (json.overflowed()) {
+                fail(out, 500, "{\"error\":\"Too large\"}");
+                return false;
+            }
+            return true;
+        }
+    }
+    fail(out, 503, "{\"error\":\"Busy\"}");
+    return false;
+}
+
+bool ApiHandler::writeRecordSeries(const SeriesQuery& query, uint16_t archiveId, ApiResponse& out) {
+    if (archiveId > 0) {
+        if (!loadArchive || !loadArchive(archiveContext, archiveId, archiveBuffer)) {
+            fail(out, 404, "{\"error\":\"Not found\"}");
+            return false;
+        }
+        JsonWriter json(bulkBuffer, sizeof(bulkBuffer));
+        writeSeriesJson(json, "records", query, archiveBuffer.recordCount, readRecord, archiveBuffer.records);
+        if (json.overflowed()) {
+            fail(out, 500, "{\"error\":\"Too large\"}");
+            return false;
+        }
+        return true;
+    }
+
+    for (uint8_t attempt = 0; attempt < API_READ_RETRIES; attempt++) {
+        uint32_t token = recordsSequence.load(std::memory_order_acquire);
+        JsonWriter json(bulkBuffer, sizeof(bulkBuffer));
+        writeSeriesJson(json, "records", query, recordCount, readRecord, records);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ((token & 1) == 0 && recordsSequence.load(std::memory_order_relaxed) == token) {
+            if (json.overflowed()) {
+                fail(out, 500, "{\"error\":\"Too large\"}");
+                return false;
+            }
+            return true;
+        }
+    }
+    fail(out, 503, "{\"error\":\"Busy\"}");
+    return false;
+}
+
+// ============= Параметри =============
+
+bool ApiHandler::getParam(const char* query, const char* name, char* out, size_t size) {
+    size_t nameLength = strlen(name);
+    for (const char* p = query; p && *p; ) {
+        if (strncmp(p, name, nameLength) == 0 && p[nameLength] == '=') {
+            const char* value = p + nameLength + 1;
+            size_t length = strcspn(value, "&");
+            if (length >= size) {
+                length = size - 1;
+            }
+            memcpy(out, value, length);
+            out[length] = '\0';
+            return true;
+        }
+        p = strchr(p, '&');
+        if (p) p++;
+    }
+    return false;
+}
+
+// ?session=<id> на архивна сесия
+static bool parseArchiveId(const char* query, uint16_t& archiveId) {
+    char value[16];
+    if (ApiHandler::getParam(query, "session", value, sizeof(value))) {
+        long id = atol(value);
+        if (id <= 0 || id > 0xFFFF) return false;
+        archiveId = id;
+    }
+    return true;
+}
+
+bool ApiHandler::parseHistoryQuery(const char* query, HistoryQuery& out, uint16_t& archiveId) {
+    char value[32];
+    if (getParam(query, "since", value, sizeof(value))) {
+        long since = atol(value);
+        if (since < 0) return false;
+        out.since = since;
+    }
+    if (getParam(query, "since_ts", value, sizeof(value))) {
+        out.sinceTs = strtoul(value, nullptr, 10);
+        out.hasSinceTs = true;
+    }
+    if (getParam(query, "from", value, sizeof(value))) {
+        out.from = strtoul(value, nullptr, 10);
+        out.hasFrom = true;
+    }
+    if (getParam(query, "to", value, sizeof(value))) {
+        out.to = strtoul(value, nullptr, 10);
+        out.hasTo = true;
+    }
+    if (getParam(query, "limit", value, sizeof(value))) {
+        long limit = atol(value);
+        if (limit < 0) return false;
+        out.limit = limit > MAX_DAILY_RECORDS ? MAX_DAILY_RECORDS : limit;
+    }
+    if (getParam(query, "fields", value, sizeof(value))) {
+        out.fields = parseHistoryFields(value);
+        if (out.fields == 0) return false;
+    }
+    return parseArchiveId(query, archiveId);
+}
+
+bool ApiHandler::parseSeriesQuery(const char* query, SeriesQuery& out, uint16_t& archiveId, bool& fromRecords) {
+    char value[16];
+    // src=samples (минутен лог, по подразбиране) или src=records (дневни записи)
+    fromRecords = false;
+    if (getParam(query, "src", value, sizeof(value))) {
+        if (strcmp(value, "records") == 0) {
+            fromRecords = true;
+        } else if (strcmp(value, "samples") != 0) {
+            return false;
+        }
+    }
+    if (getParam(query, "from", value, sizeof(value))) {
+        out.from = strtoul(value, nullptr, 10);
+        out.hasFrom = true;
+    }
+    if (getParam(query, "to", value, sizeof(value))) {
+        out.to = strtoul(value, nullptr, 10);
+        out.hasTo = true;
+    }
+    if (out.hasFrom && out.hasTo && out.to < out.from) {
+        return false;
+    }
+    if (getParam(query, "points", value, sizeof(value))) {
+        long points = atol(value);
+        if (points < 2) return false;
+        out.points = points > SERIES_MAX_POINTS ? SERIES_MAX_POINTS : points;
+    }
+    if (getParam(query, "mode", value, sizeof(value))) {
+        if (!parseSeriesMode(value, out.mode)) return false;
+    }
+    return parseArchiveId(query, archiveId);
+}
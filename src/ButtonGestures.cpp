@@ -0,0 +1,151 @@
+#include "ButtonGestures.h"
+
+// Разлика между времена в ms, вярна и при превъртане на millis()
+static int32_t elapsed(uint32_t from, uint32_t to) {
+    return (int32_t)(to - from);
+}
+
+ButtonGestures::ButtonGestures() {
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        reset(i, false);
+        buttons[i].doublePress = false;
+    }
+    eventHead = 0;
+    eventCount = 0;
+    droppedEvents = 0;
+}
+
+void ButtonGestures::reset(uint8_t button, bool pressed) {
+    if (button >= BUTTON_COUNT) {
+        return;
+    }
+    Button& b = buttons[button];
+    b.raw = pressed;
+    b.rawAt = 0;
+    b.stable = pressed;
+    // Натиснат при старта - чака се отпускане, без събитие
+    b.state = STATE_IDLE;
+    b.pressedAt = 0;
+    b.releasedAt = 0;
+    b.longFired = pressed;
+}
+
+void ButtonGestures::enableDoublePress(uint8_t button, bool enable) {
+    if (button < BUTTON_COUNT) {
+        buttons[button].doublePress = enable;
+    }
+}
+
+void ButtonGestures::edge(uint8_t button, bool pressed, uint32_t timeMs) {
+    if (button >= BUTTON_COUNT) {
+        return;
+    }
+    // Предишното ниво важи, ако е издържало debounce преди този фронт
+    advance(button, timeMs);
+
+    Button& b = buttons[button];
+    b.raw = pressed;
+    b.rawAt = timeMs;
+}
+
+void ButtonGestures::poll(uint32_t nowMs) {
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        advance(i, nowMs);
+    }
+}
+
+void ButtonGestures::advance(uint8_t index, uint32_t timeMs) {
+    Button& b = buttons[index];
+    if (b.raw != b.stable && elapsed(b.rawAt, timeMs) >= (int32_t)DEBOUNCE_MS) {
+        checkTimers(index, b.rawAt);
+        b.stable = b.raw;
+        transition(index, b.stable, b.rawAt);
+    }
+    checkTimers(index, timeMs);
+}
+
+void ButtonGestures::checkTimers(uint8_t index, uint32_t timeMs) {
+    Button& b = buttons[index];
+
+    if (b.state == STATE_DOWN && !b.longFired &&
+        elapsed(b.pressedAt, timeMs) >= (int32_t)LONG_PRESS_MS) {
+        b.longFired = true;
+        emit(index, BUTTON_LONG_PRESS, b.pressedAt + LONG_PRESS_MS);
+    }
+    if (b.state == STATE_WAIT_SECOND &&
+        elapsed(b.releasedAt, timeMs) > (int32_t)DOUBLE_PRESS_MS) {
+        b.state = STATE_IDLE;
+        emit(index, BUTTON_PRESS, b.releasedAt);
+    }
+}
+
+void ButtonGestures::transition(uint8_t index, bool pressed, uint32_t timeMs) {
+    Button& b = buttons[index];
+
+    switch (b.state) {
+        case STATE_IDLE:
+            if (pressed) {
+                b.state = STATE_DOWN;
+                b.pressedAt = timeMs;
+                b.longFired = false;
+            } else {
+                b.longFired = false;
+            }
+            break;
+
+        case STATE_DOWN:
+            if (pressed) {
+                break;
+            }
+            if (b.longFired) {
+                b.state = STATE_IDLE;
+            } else if (b.doublePress) {
+                b.state = STATE_WAIT_SECOND;
+                b.releasedAt = timeMs;
+            } else {
+                b.state = STATE_IDLE;
+                emit(index, BUTTON_PRESS, timeMs);
+            }
+            break;
+
+        case STATE_WAIT_SECOND:
+            if (pressed) {
+                b.state = STATE_SECOND_DOWN;
+                b.pressedAt = timeMs;
+            }
+            break;
+
+        case STATE_SECOND_DOWN:
+            if (!pressed) {
+                b.state = STATE_IDLE;
+                emit(index, BUTTON_DOUBLE_PRESS, timeMs);
+            }
+            break;
+    }
+}
+
+void ButtonGestures::emit(uint8_t index, ButtonEventType type, uint32_t timeMs) {
+    if (eventCount >= BUTTON_EVENT_QUEUE) {
+        droppedEvents++;
+        return;
+    }
+    ButtonEvent& event = events[(eventHead + eventCount) % BUTTON_EVENT_QUEUE];
+    event.button = index;
+    event.type = type;
+    event.timeMs = timeMs;
+    eventCount++;
+}
+
+bool ButtonGestures::pop(ButtonEvent& event) {
+    if (eventCount == 0) {
+        return false;
+    }
+    event = events[eventHead];
+    eventHead = (eventHead + 1) % BUTTON_EVENT_QUEUE;
+    eventCount--;
+    return true;
+}
+
+bool ButtonGestures::isPressed(uint8_t button) const {
+    return button < BUTTON_COUNT && buttons[button].stable;
+}
@@ -1,138 +1,135 @@
 #include "ButtonHandler.h"
 
-// Референция към флага за съобщения от main.cpp
-extern bool showingMessage;
-extern unsigned long messageDisplayTime;
-extern unsigned long lastDisplayUpdate;
-extern float lastDisplayedWeight;
+// Индекси на бутоните в gestures
+#define BTN_TARE  0
+#define BTN_UNIT  1
+#define BTN_START 2
 
-ButtonHandler::ButtonHandler(uint8_t tarePin, uint8_t unitPin, uint8_t startPin) {
+ButtonHandler::ButtonHandler(uint8_t tarePin, uint8_t unitPin, uint8_t startPin)
+    : edgeHead(0), edgeTail(0) {
     btnTarePin = tarePin;
     btnUnitPin = unitPin;
     btnStartPin = startPin;
     
     currentMode = OP_MODE_NORMAL;
     historyIndex = 0;
-    lastButtonCheck = 0;
+    uiRequests = 0;
+    edgesDropped = 0;
+    edgeLog = false;
     
-    for (int i = 0; i < 3; i++) {
-        lastButtonStates[i] = HIGH;
-        buttonPressTime[i] = 0;
-        buttonHoldDetected[i] = false;
+    const uint8_t pins[BUTTON_COUNT] = { tarePin, unitPin, startPin };
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        pinContexts[i].handler = this;
+        pinContexts[i].button = i;
+        pinContexts[i].pin = pins[i];
     }
+    
+    // UNIT: двойно натискане = бърз преход (grams / графиката)
+    gestures.enableDoublePress(BTN_UNIT, true);
 }
 
 void ButtonHandler::begin() {
-    pinMode(btnTarePin, INPUT_PULLUP);
-    pinMode(btnUnitPin, INPUT_PULLUP);
-    pinMode(btnStartPin, INPUT_PULLUP);
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        pinMode(pinContexts[i].pin, INPUT_PULLUP);
+        gestures.reset(i, digitalRead(pinContexts[i].pin) == LOW);
+        attachInterruptArg(pinContexts[i].pin, onEdge, &pinContexts[i], CHANGE);
+    }
     
-    Serial.println("[Buttons] Initialized");
+    Serial.println("[Buttons] Initialized (interrupts)");
 }
 
-void ButtonHandler::update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display, float currentWeight) {
-    unsigned long currentTime = millis();
+// Само записва фронта с времето му - разпознаването е в update()
+void IRAM_ATTR ButtonHandler::onEdge(void* arg) {
+    PinContext* context = static_cast<PinContext*>(arg);
+    ButtonHandler* self = context->handler;
     
-    if (currentTime - lastButtonCheck < DEBOUNCE_MS) {
+    uint8_t head = self->edgeHead.load(std::memory_order_relaxed);
+    uint8_t next = (head + 1) % BUTTON_EDGE_QUEUE;
+    if (next == self->edgeTail.load(std::memory_order_acquire)) {
+        // Пълна опашка - следващият фронт носи нивото си, така че се наваксва
+        self->edgesDropped = self->edgesDropped + 1;
         return;
     }
     
-    // Четене на текущо състояние на бутоните
-    bool currentStates[3] = {
-        digitalRead(btnTarePin),
-        digitalRead(btnUnitPin),
-        digitalRead(btnStartPin)
-    };
-    
-    // Обработка на hold detection САМО ЗА START бутон
-    if (currentStates[2] == LOW) {
-        if (buttonPressTime[2] == 0) {
-            buttonPressTime[2] = currentTime;
+    RawEdge& edge = self->edges[head];
+    edge.button = context->button;
+    edge.pressed = digitalRead(context->pin) == LOW;
+    edge.timeMs = millis();
+    self->edgeHead.store(next, std::memory_order_release);
+}
+
+void ButtonHandler::update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display) {
+    // Фронтовете от прекъсванията, в реда им
+    uint8_t tail = edgeTail.load(std::memory_order_relaxed);
+    while (tail != edgeHead.load(std::memory_order_acquire)) {
+        const RawEdge& edge = edges[tail];
+        if (edgeLog) {
+            Serial.printf("%lu %s %s\n", (unsigned long)edge.timeMs,
+                          edge.pressed ? "down" : "up", buttonName(edge.button));
         }
-        
-        if (!buttonHoldDetected[2] && (currentTime - buttonPressTime[2] >= HOLD_MS)) {
-            buttonHoldDetected[2] = true;
-            
-            // START HOLD ACTION - Превключване режим или край на сесия
+        gestures.edge(edge.button, edge.pressed, edge.timeMs);
+        tail = (tail + 1) % BUTTON_EDGE_QUEUE;
+        edgeTail.store(tail, std::memory_order_release);
+    }
+    // След опашката - всички прочетени фронтове са преди това време
+    gestures.poll(millis());
+    
+    ButtonEvent event;
+    while (gestures.pop(event)) {
+        // START задържане - превключване режим или край на сесия
+        if (event.button == BTN_START && event.type == BUTTON_LONG_PRESS) {
             if (currentMode == OP_MODE_NORMAL) {
                 // Преминаване в Drying Mode + Нова сесия
                 if (!drying.isActive()) {
-                    float initialWeight = scale.getRawWeight();
-                    
-                    if (!isnan(initialWeight) && abs(initialWeight) > 5.0f) {
-                        drying.startNewSession(abs(initialWeight), 40.0f);
-                        currentMode = OP_MODE_DRYING;
-                        display.setMode(DisplayManager::MODE_DRYING_LIVE);
-                        display.showSessionStart(abs(initialWeight));
-                        
-                        // Активирай временно съобщение
-                        showingMessage = true;
-                        messageDisplayTime = millis();
-                        
-                        Serial.println("[Buttons] Switched to DRYING mode");
-                    } else {
-                        display.showMessage("Error", "Invalid weight", 0);
-                        showingMessage = true;
-                        messageDisplayTime = millis();
-                        Serial.printf("[Buttons] Invalid weight: %.1f\n", initialWeight);
-                    }
+                    startSession(scale, drying, display);
                 }
             } else {
                 // Край на сесия + връщане в Normal Mode
-                drying.endSession();
-                currentMode = OP_MODE_NORMAL;
-                display.setMode(DisplayManager::MODE_NORMAL);
-                display.showSessionEnd();
-
-                 // Форсирай display update след съобщението
-    lastDisplayUpdate = 0;
-    lastDisplayedWeight = -999.0f;  // ← ДОБАВИ ТОВА! Форсира обновяван
-                
-                // Активирай временно съобщение
-                showingMessage = true;
-                messageDisplayTime = millis();
-                
-                Serial.println("[Buttons] Switched to NORMAL mode");
+                stopSession(drying, display);
             }
+            continue;
         }
-    } else {
-        resetButton(2);
-    }
-    
-    // Обработка на нормални натискания (само ако няма hold на START)
-    if (!buttonHoldDetected[2]) {
+        
         if (currentMode == OP_MODE_NORMAL) {
-            handleNormalMode(scale, display);
+            handleNormalMode(event, scale, display);
         } else {
-            handleDryingMode(scale, drying, display, currentWeight);
+            handleDryingMode(event, drying, display);
         }
     }
-    
-    // Запазване на състоянията
-    for (int i = 0; i < 3; i++) {
-        lastButtonStates[i] = currentStates[i];
-    }
-    
-    lastButtonCheck = currentTime;
 }
 
-void ButtonHandler::handleNormalMode(ScaleManager& scale, DisplayManager& display) {
+void ButtonHandler::injectEdge(uint8_t button, bool pressed, uint32_t timeMs) {
+    gestures.edge(button, pressed, timeMs);
+}
+
+void ButtonHandler::setEdgeLog(bool enabled) {
+    edgeLog = enabled;
+    Serial.printf("[Buttons] Edge log %s\n", enabled ? "ON" : "OFF");
+}
+
+const char* ButtonHandler::buttonName(uint8_t button) {
+    static const char* const NAMES[BUTTON_COUNT] = { "TARE", "UNIT", "START" };
+    return button < BUTTON_COUNT ? NAMES[button] : "?";
+}
+
+void ButtonHandler::handleNormalMode(const ButtonEvent& event, ScaleManager& scale, DisplayManager& display) {
     // TARE бутон - тариране
-    if (isButtonPressed(0)) {
+    if (event.button == BTN_TARE && event.type == BUTTON_PRESS) {
         scale.performTare();
         Serial.println("[Buttons] Tare");
     }
     
-    // UNIT бутон - смяна единици
-    if (isButtonPressed(1)) {
-        ScaleManager::WeightUnit currentUnit = scale.getUnit();
-        ScaleManager::WeightUnit nextUnit = (ScaleManager::WeightUnit)((currentUnit + 1) % 4);
+    // UNIT бутон - смяна единици (двойно натискане - обратно към грамове)
+    if (event.button == BTN_UNIT && event.type != BUTTON_LONG_PRESS) {
+        ScaleManager::WeightUnit nextUnit = ScaleManager::GRAMS;
+        if (event.type == BUTTON_PRESS) {
+            nextUnit = (ScaleManager::WeightUnit)((scale.getUnit() + 1) % 4);
+        }
         scale.setUnit(nextUnit);
-        display.showUnitChange(scale.getUnitString());
+        display.showUnitChange(scale.getUnit());
         
         // Активирай временно съобщение
-        showingMessage = true;
-        messageDisplayTime = millis();
+        uiRequests |= UI_MESSAGE_SHOWN;
         
         Serial.println("[Buttons] Unit changed");
     }
@@ -140,17 +137,17 @@ void ButtonHandler::handleNormalMode(ScaleManager& scale, DisplayManager& displa
     // START бутон (кратко) - няма действие в Normal Mode
 }
 
-void ButtonHandler::handleDryingMode(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display, float currentWeight) {
+void ButtonHandler::handleDryingMode(const ButtonEvent& event, DryingSessionManager& drying, DisplayManager& display) {
     DisplayManager::DisplayMode displayMode = display.getMode();
     
     // TARE бутон - Навигация НАЗАД във времето (по-стари дни)
-    if (isButtonPressed(0)) {
+    if (event.button == BTN_TARE && event.type == BUTTON_PRESS) {
         if (displayMode == DisplayManager::MODE_DRYING_LIVE) {
             // От Live → покажи предпоследния ден
             if (drying.getRecordCount() > 1) {
                 historyIndex = drying.getRecordCount() - 2;
                 display.setMode(DisplayManager::MODE_DRYING_HISTORY);
-                lastDisplayUpdate = 0;
+                uiRequests |= UI_REDRAW;
                 Serial.printf("[Buttons] History - Day %d\n", historyIndex);
             }
         } 
@@ -158,7 +155,7 @@ void ButtonHandler::handleDryingMode(ScaleManager& scale, DryingSessionManager&
             // Навигация назад (по-стар запис)
             if (historyIndex > 0) {
                 historyIndex--;
-                lastDisplayUpdate = 0;
+                uiRequests |= UI_REDRAW;
                 Serial.printf("[Buttons] History - Day %d (older)\n", historyIndex);
             } else {
                 Serial.println("[Buttons] Already at oldest record");
@@ -167,78 +164,118 @@ void ButtonHandler::handleDryingMode(ScaleManager& scale, DryingSessionManager&
         else if (displayMode == DisplayManager::MODE_DRYING_STATS) {
             // От Stats → обратно към Live
             display.setMode(DisplayManager::MODE_DRYING_LIVE);
-            lastDisplayUpdate = 0;
+            uiRequests |= UI_REDRAW;
             Serial.println("[Buttons] Back to Live from Stats");
         }
+        else if (displayMode == DisplayManager::MODE_DRYING_GRAPH) {
+            // От Graph → обратно към Stats
+            display.setMode(DisplayManager::MODE_DRYING_STATS);
+            uiRequests |= UI_REDRAW;
+            Serial.println("[Buttons] Back to Stats from Graph");
+        }
+    }
+    
+    // UNIT бутон (двойно) - директно към графиките
+    if (event.button == BTN_UNIT && event.type == BUTTON_DOUBLE_PRESS) {
+        if (displayMode != DisplayManager::MODE_DRYING_GRAPH) {
+            display.setMode(DisplayManager::MODE_DRYING_GRAPH);
+            uiRequests |= UI_REDRAW;
+            Serial.println("[Buttons] Switched to Graph (double)");
+        }
     }
     
     // UNIT бутон - Навигация НАПРЕД / циклична смяна
-    if (isButtonPressed(1)) {
+    if (event.button == BTN_UNIT && event.type == BUTTON_PRESS) {
         if (displayMode == DisplayManager::MODE_DRYING_LIVE) {
             display.setMode(DisplayManager::MODE_DRYING_STATS);
-            lastDisplayUpdate = 0;
+            uiRequests |= UI_REDRAW;
             Serial.println("[Buttons] Switched to Stats");
         } 
         else if (displayMode == DisplayManager::MODE_DRYING_STATS) {
-            // От Stats → History (показваме ПОСЛЕДНИЯ ден)
+            display.setMode(DisplayManager::MODE_DRYING_GRAPH);
+            uiRequests |= UI_REDRAW;
+            Serial.println("[Buttons] Switched to Graph");
+        }
+        else if (displayMode == DisplayManager::MODE_DRYING_GRAPH) {
+            // От Graph → History (показваме ПОСЛЕДНИЯ ден) или Live без записи
             if (drying.getRecordCount() > 0) {
                 historyIndex = drying.getRecordCount() - 1;
                 display.setMode(DisplayManager::MODE_DRYING_HISTORY);
-                lastDisplayUpdate = 0;
+                uiRequests |= UI_REDRAW;
                 Serial.printf("[Buttons] History - Day %d (latest)\n", historyIndex);
+            } else {
+                display.setMode(DisplayManager::MODE_DRYING_LIVE);
+                uiRequests |= UI_REDRAW;
+                Serial.println("[Buttons] Back to Live (cycle)");
             }
         }
         else if (displayMode == DisplayManager::MODE_DRYING_HISTORY) {
             // Навигация напред (по-нов запис) ИЛИ wrap към Live
             if (historyIndex < drying.getRecordCount() - 1) {
                 historyIndex++;
-                lastDisplayUpdate = 0;
+                uiRequests |= UI_REDRAW;
                 Serial.printf("[Buttons] History - Day %d (newer)\n", historyIndex);
             } else {
                 // Вече сме на най-новия → обратно към Live
                 display.setMode(DisplayManager::MODE_DRYING_LIVE);
-                lastDisplayUpdate = 0;
+                uiRequests |= UI_REDRAW;
                 Serial.println("[Buttons] Back to Live (cycle)");
             }
         }
     }
     
     // START бутон (кратко) - Директно към Live от всякъде
-    if (isButtonPressed(2) && !buttonHoldDetected[2]) {
+    if (event.button == BTN_START && event.type == BUTTON_PRESS) {
         if (displayMode != DisplayManager::MODE_DRYING_LIVE) {
             display.setMode(DisplayManager::MODE_DRYING_LIVE);
-            lastDisplayUpdate = 0;
+            uiRequests |= UI_REDRAW;
             Serial.println("[Buttons] Back to Live (START)");
         }
     }
 }
 
-bool ButtonHandler::isButtonPressed(uint8_t buttonIndex) {
-    uint8_t pin;
-    switch(buttonIndex) {
-        case 0: pin = btnTarePin; break;
-        case 1: pin = btnUnitPin; break;
-        case 2: pin = btnStartPin; break;
-        default: return false;
-    }
-    
-    bool currentState = digitalRead(pin);
+bool ButtonHandler::startSession(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display,
+                                 float targetLossPercent) {
+    float initialWeight = scale.getRawWeight();
     
-    // Pressed = LOW (falling edge) and not in hold
-    if (currentState == LOW && lastButtonStates[buttonIndex] == HIGH && !buttonHoldDetected[buttonIndex]) {
+    if (!isnan(initialWeight) && abs(initialWeight) > 5.0f) {
+        drying.startNewSession(abs(initialWeight), targetLossPercent);
+        currentMode = OP_MODE_DRYING;
+        display.setMode(DisplayManager::MODE_DRYING_LIVE);
+        display.showSessionStart(abs(initialWeight));
+        
+        // Активирай временно съобщение
+        uiRequests |= UI_MESSAGE_SHOWN;
+        
+        Serial.println("[Buttons] Switched to DRYING mode");
         return true;
     }
     
+    display.showMessage("Error", "Invalid weight", 0);
+    uiRequests |= UI_MESSAGE_SHOWN;
+    Serial.printf("[Buttons] Invalid weight: %.1f\n", initialWeight);
     return false;
 }
 
-bool ButtonHandler::isButtonHeld(uint8_t buttonIndex) {
-    return buttonHoldDetected[buttonIndex];
+void ButtonHandler::stopSession(DryingSessionManager& drying, DisplayManager& display) {
+    drying.endSession();
+    currentMode = OP_MODE_NORMAL;
+    display.setMode(DisplayManager::MODE_NORMAL);
+    display.showSessionEnd();
+    
+    // Форсирай display update след съобщението
+    uiRequests |= UI_REDRAW;
+    
+    // Активирай временно съобщение
+    uiRequests |= UI_MESSAGE_SHOWN;
+    
+    Serial.println("[Buttons] Switched to NORMAL mode");
 }
 
-void ButtonHandler::resetButton(uint8_t buttonIndex) {
-    buttonPressTime[buttonIndex] = 0;
-    buttonHoldDetected[buttonIndex] = false;
+uint8_t ButtonHandler::popUiRequests() {
+    uint8_t requests = uiRequests;
+    uiRequests = 0;
+    return requests;
 }
 
 ButtonHandler::OperationMode ButtonHandler::getMode() {
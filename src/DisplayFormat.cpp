@@ -0,0 +1,191 @@
+#include "DisplayFormat.h"
+#include <string.h>
+
+// 10^n за закръгляне (до 3 знака след точката стигат за екраните)
+static const uint32_t POW10[] = { 1, 10, 100, 1000 };
+static const uint8_t MAX_DECIMALS = 3;
+
+static const UnitFormat UNIT_FORMATS[] = {
+    { "g",  "GRAMS",     1.0f,        2.0f,   1 },
+    { "kg", "KILOGRAMS", 0.001f,      0.002f, 3 },
+    { "oz", "OUNCES",    0.035274f,   0.07f,  2 },
+    { "lb", "POUNDS",    0.00220462f, 0.004f, 3 },
+};
+
+const UnitFormat& unitFormat(uint8_t unit) {
+    if (unit >= sizeof(UNIT_FORMATS) / sizeof(UNIT_FORMATS[0])) {
+        unit = 0;
+    }
+    return UNIT_FORMATS[unit];
+}
+
+// ============= Числа =============
+
+static size_t putUnsigned(char* out, size_t size, uint32_t v) {
+    char tmp[10];
+    size_t n = 0;
+    do {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v > 0);
+
+    size_t written = 0;
+    while (n > 0 && written + 1 < size) {
+        out[written++] = tmp[--n];
+    }
+    return written;
+}
+
+size_t formatFixed(char* out, size_t size, float value, uint8_t decimals) {
+    if (size == 0) {
+        return 0;
+    }
+    size_t len = 0;
+
+    if (!(value > -1e9f && value < 1e9f)) {
+        if (size > 3) {
+            memcpy(out, "---", 3);
+            len = 3;
+        }
+        out[len] = '\0';
+        return len;
+    }
+    if (decimals > MAX_DECIMALS) {
+        decimals = MAX_DECIMALS;
+    }
+
+    uint32_t scale = POW10[decimals];
+    bool negative = value < 0;
+    float magnitude = negative ? -value : value;
+    uint64_t fixed;
+    if (magnitude * scale < 8388608.0f) {
+        // Точно във float (2^23) - ESP32 има FPU само за float
+        fixed = (uint64_t)(magnitude * scale + 0.5f);
+    } else {
+        fixed = (uint64_t)((double)magnitude * scale + 0.5);
+    }
+
+    if (negative && fixed != 0 && len + 1 < size) {
+        out[len++] = '-';
+    }
+    len += putUnsigned(out + len, size - len, (uint32_t)(fixed / scale));
+
+    if (decimals > 0 && len + decimals + 1 < size) {
+        uint32_t rest = (uint32_t)(fixed % scale);
+        out[len] = '.';
+        for (uint8_t i = decimals; i > 0; i--) {
+            out[len + i] = '0' + (rest % 10);
+            rest /= 10;
+        }
+        len += decimals + 1;
+    }
+    out[len] = '\0';
+    return len;
+}
+
+size_t formatWeight(char* out, size_t size, float grams, uint8_t unit) {
+    const UnitFormat& format = unitFormat(unit);
+    float weight = grams * format.perGram;
+    float magnitude = weight < 0 ? -weight : weight;
+
+    if (magnitude <= format.zeroThreshold) {
+        return formatFixed(out, size, 0.0f, 1);
+    }
+    // Над 1 kg в грамове - без десетични (иначе не се събира с размер 3)
+    if (unit == 0 && magnitude >= 1000.0f) {
+        TextBuilder text(out, size);
+        text.add((int32_t)weight);
+        return text.length();
+    }
+    return formatFixed(out, size, weight, format.decimals);
+}
+
+// ============= TextBuilder =============
+
+TextBuilder::TextBuilder(char* buffer, size_t size) {
+    buf = buffer;
+    cap = size;
+    len = 0;
+    if (cap > 0) {
+        buf[0] = '\0';
+    }
+}
+
+TextBuilder& TextBuilder::add(const char* s) {
+    while (*s && len + 1 < cap) {
+        buf[len++] = *s++;
+    }
+    if (cap > 0) {
+        buf[len] = '\0';
+    }
+    return *this;
+}
+
+TextBuilder& TextBuilder::add(int32_t v) {
+    if (cap == 0) {
+        return *this;
+    }
+    uint32_t magnitude = (uint32_t)v;
+    if (v < 0) {
+        if (len + 1 < cap) buf[len++] = '-';
+        magnitude = 0u - magnitude;
+    }
+    len += putUnsigned(buf + len, cap - len, magnitude);
+    buf[len] = '\0';
+    return *this;
+}
+
+TextBuilder& TextBuilder::add(float v, uint8_t decimals) {
+    if (cap > len) {
+        len += formatFixed(buf + len, cap - len, v, decimals);
+    }
+    return *this;
+}
+
+// ============= LayoutCache =============
+
+LayoutCache::LayoutCache(int16_t screenWidth, int16_t screenHeight) {
+    width = screenWidth;
+    height = screenHeight;
+    for (uint8_t size = 0; size < DISPLAY_MAX_TEXT_SIZE; size++) {
+        for (uint8_t length = 0; length < DISPLAY_MAX_LINE; length++) {
+            centerX[size][length] = UNMEASURED;
+        }
+    }
+    memset(weightLayout, 0, sizeof(weightLayout));
+    memset(weightMeasured, 0, sizeof(weightMeasured));
+}
+
+int16_t LayoutCache::centeredX(uint8_t textSize, uint8_t length) {
+    if (textSize < 1) textSize = 1;
+    if (textSize > DISPLAY_MAX_TEXT_SIZE) textSize = DISPLAY_MAX_TEXT_SIZE;
+    if (length >= DISPLAY_MAX_LINE) length = DISPLAY_MAX_LINE - 1;
+
+    int16_t& x = centerX[textSize - 1][length];
+    if (x == UNMEASURED) {
+        x = (width - length * FONT_CHAR_WIDTH * textSize) / 2;
+    }
+    return x;
+}
+
+const TextLayout& LayoutCache::weight(uint8_t length) {
+    if (length >= DISPLAY_MAX_LINE) length = DISPLAY_MAX_LINE - 1;
+
+    TextLayout& layout = weightLayout[length];
+    if (!weightMeasured[length]) {
+        // Размер 3, освен ако текстът не оставя поне 10 px поле
+        uint8_t size = 3;
+        if (length * FONT_CHAR_WIDTH * size > width - 10) {
+            size = 2;
+        }
+        layout.size = size;
+        layout.x = (width - length * FONT_CHAR_WIDTH * size) / 2;
+        layout.y = (height - size * FONT_CHAR_HEIGHT) / 2 - 5;
+        weightMeasured[length] = true;
+    }
+    return layout;
+}
+
+int16_t LayoutCache::rightX(uint8_t textSize, uint8_t length, int16_t margin) {
+    return width - length * FONT_CHAR_WIDTH * textSize - margin;
+}
@@ -1,8 +1,24 @@
 #include "DisplayManager.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+#include "Trace.h"
+
+// Кадърът за изпращане се подава от loop() на задачата на дисплея
+static portMUX_TYPE frameMux = portMUX_INITIALIZER_UNLOCKED;
 
 DisplayManager::DisplayManager() 
-    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET) {
+    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET, I2C_CLOCK_FAST, I2C_CLOCK_FAST),
+      layouts(SCREEN_WIDTH, SCREEN_HEIGHT) {
     currentMode = MODE_NORMAL;
+    memset(lastFrame, 0, sizeof(lastFrame));
+    memset(pendingFrame, 0, sizeof(pendingFrame));
+    memset(workFrame, 0, sizeof(workFrame));
+    framePending = false;
+    taskHandle = nullptr;
+    monitorId = -1;
+    i2cClock = I2C_CLOCK_FAST;
+    framesFlushed = 0;
+    bytesSent = 0;
 }
 
 bool DisplayManager::begin() {
@@ -12,14 +28,35 @@ bool DisplayManager::begin() {
     }
     
     display.clearDisplay();
-    display.display();
-    Serial.println("[Display] Initialized successfully");
+    memcpy(workFrame, display.getBuffer(), sizeof(workFrame));
+    
+    // Fast-mode Plus, ако панелът потвърждава всеки байт; иначе 400 kHz
+    if (OLED_I2C_CLOCK_MAX > I2C_CLOCK_FAST) {
+        Wire.setClock(OLED_I2C_CLOCK_MAX);
+        if (sendFrame(true)) {
+            i2cClock = OLED_I2C_CLOCK_MAX;
+        } else {
+            Wire.setClock(I2C_CLOCK_FAST);
+        }
+    }
+    // Първият кадър е пълен - от него нататък се пращат само разликите
+    if (i2cClock == I2C_CLOCK_FAST && !sendFrame(true)) {
+        Serial.println("[Display] OLED not responding");
+        return false;
+    }
+    
+    // I2C е само на дисплея, затова задачата го държи на своята честота
+    xTaskCreatePinnedToCore(displayTask, "display", DISPLAY_TASK_STACK, this,
+                            DISPLAY_TASK_PRIORITY, &taskHandle, DISPLAY_TASK_CORE);
+    monitorId = taskMonitor.add("display", taskHandle, DISPLAY_TASK_CORE, DISPLAY_TASK_PRIORITY);
+    
+    Serial.printf("[Display] Initialized successfully (I2C %lu kHz)\n", (unsigned long)(i2cClock / 1000));
     return true;
 }
 
 void DisplayManager::clear() {
     display.clearDisplay();
-    display.display();
+    flush();
 }
 
 void DisplayManager::setMode(DisplayMode mode) {
@@ -31,84 +68,169 @@ DisplayManager::DisplayMode DisplayManager::getMode() {
     return currentMode;
 }
 
-// ============= NORMAL MODE =============
+// ============= ИЗПРАЩАНЕ КЪМ OLED =============
 
-void DisplayManager::showNormalWeight(float weight, String unit) {
-    display.clearDisplay();
-    display.setTextColor(SSD1306_WHITE);
-    
-    // Форматиране на теглото
-    String weightStr;
-    
-    // Проверка за нула според единицата
-    float zeroThreshold;
-    if (unit == "kg") {
-        zeroThreshold = 0.002f;  // 2 грама в kg
-    } else if (unit == "lb") {
-        zeroThreshold = 0.004f;  // 2 грама в lb
-    } else if (unit == "oz") {
-        zeroThreshold = 0.07f;   // 2 грама в oz
-    } else {
-        zeroThreshold = 2.0f;    // 2 грама
+// Вика се от show*() в loop(): само копира кадъра (1 KB) и буди задачата.
+// I2C трансферът е в задачата, така че loop() не чака шината.
+void DisplayManager::flush() {
+    const uint8_t* frame = display.getBuffer();
+    
+    portENTER_CRITICAL(&frameMux);
+    bool changed = memcmp(pendingFrame, frame, sizeof(pendingFrame)) != 0;
+    if (changed) {
+        memcpy(pendingFrame, frame, sizeof(pendingFrame));
+        framePending = true;
     }
+    portEXIT_CRITICAL(&frameMux);
     
-    if (abs(weight) <= zeroThreshold) {
-        weightStr = "0.0";
-    } else {
-        if (unit == "g" && abs(weight) >= 1000) {
-            weightStr = String((int)weight);
-        } else if (unit == "kg") {
-            weightStr = String(weight, 3);  // 3 decimal places
-        } else if (unit == "oz") {
-            weightStr = String(weight, 2);  // 2 decimal places
-        } else if (unit == "lb") {
-            weightStr = String(weight, 3);  // 3 decimal places
+    // Непроменен кадър не буди задачата
+    if (changed && taskHandle) {
+        xTaskNotifyGive(taskHandle);
+    }
+}
+
+void DisplayManager::displayTask(void* context) {
+    static_cast<DisplayManager*>(context)->runTask();
+}
+
+void DisplayManager::runTask() {
+    bool retry = false;
+    for (;;) {
+        // Кадър се праща само при промяна; без промени дълго време -
+        // пълен кадър, в случай че OLED е изпуснал нещо. След неуспешен
+        // трансфер неизпратените страници се пращат отново скоро.
+        uint32_t waitMs = retry ? DISPLAY_RETRY_MS : DISPLAY_RESYNC_MS;
+        bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0;
+        
+        portENTER_CRITICAL(&frameMux);
+        bool fresh = framePending;
+        memcpy(workFrame, pendingFrame, sizeof(workFrame));
+        framePending = false;
+        portEXIT_CRITICAL(&frameMux);
+        
+        if (woken && !fresh) {
+            continue;  // Кадърът вече е изпратен с предишното събуждане
+        }
+        
+        unsigned long start = micros();
+        retry = !sendFrame(!woken && !retry);
+        uint32_t elapsed = micros() - start;
+        metrics.displayFlushUs.observe(elapsed);
+        taskMonitor.addBusy(monitorId, elapsed);
+        
+        // Горна граница на кадрите - междинните кадри се сливат в последния
+        vTaskDelay(pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS));
+    }
+}
+
+// Сравнява workFrame с последно изпратения кадър по страници (8 реда) и
+// праща само променения диапазон колони във всяка променена страница
+bool DisplayManager::sendFrame(bool full) {
+    TRACE_SCOPE("oled_send");
+    uint16_t sent = 0;
+    bool ok = true;
+    
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        const uint8_t* row = workFrame + page * SCREEN_WIDTH;
+        uint8_t* last = lastFrame + page * SCREEN_WIDTH;
+        
+        uint8_t first = 0;
+        uint8_t end = SCREEN_WIDTH - 1;
+        if (!full) {
+            while (first < SCREEN_WIDTH && row[first] == last[first]) first++;
+            if (first == SCREEN_WIDTH) {
+                continue;  // Страницата не е променена
+            }
+            while (row[end] == last[end]) end--;
+        }
+        
+        // lastFrame е каквото OLED наистина има - неуспешна страница остава
+        // различна и влиза в следващото изпращане
+        if (sendPage(page, first, end, row)) {
+            memcpy(last + first, row + first, end - first + 1);
         } else {
-            weightStr = String(weight, 1);  // 1 decimal place
+            ok = false;
+        }
+        sent += end - first + 1;
+    }
+    
+    framesFlushed++;
+    bytesSent += sent;
+    metrics.displayBytesSent.inc(sent);
+    metrics.displayBytesSaved.inc(SCREEN_FRAME_BYTES - sent);
+    return ok;
+}
+
+bool DisplayManager::sendPage(uint8_t page, uint8_t firstColumn, uint8_t lastColumn, const uint8_t* row) {
+    // Прозорец за запис: една страница, колони first..last (horizontal addressing)
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    Wire.write((uint8_t)0x00);  // Следват команди
+    Wire.write((uint8_t)SSD1306_PAGEADDR);
+    Wire.write(page);
+    Wire.write(page);
+    Wire.write((uint8_t)SSD1306_COLUMNADDR);
+    Wire.write(firstColumn);
+    Wire.write(lastColumn);
+    bool ok = Wire.endTransmission() == 0;
+    
+    // Данните на части - буферът на Wire е 32 байта с контролния
+    for (uint16_t column = firstColumn; column <= lastColumn; column += I2C_DATA_CHUNK) {
+        uint16_t count = lastColumn - column + 1;
+        if (count > I2C_DATA_CHUNK) {
+            count = I2C_DATA_CHUNK;
         }
+        Wire.beginTransmission(SCREEN_ADDRESS);
+        Wire.write((uint8_t)0x40);  // Следват данни
+        Wire.write(row + column, count);
+        ok = Wire.endTransmission() == 0 && ok;
     }
-    // Размер на текста
-    int textSize = 3;
-    int charWidth = textSize * 6;
-    int totalWidth = weightStr.length() * charWidth;
-    
-    if (totalWidth > SCREEN_WIDTH - 10) {
-        textSize = 2;
-        charWidth = textSize * 6;
-        totalWidth = weightStr.length() * charWidth;
+    return ok;
+}
+
+void DisplayManager::printStats() {
+    if (framesFlushed == 0) {
+        Serial.println("Display: no frames yet");
+        return;
     }
+    uint32_t average = bytesSent / framesFlushed;
     
-    // Центриране
-    int x = (SCREEN_WIDTH - totalWidth) / 2;
-    int y = (SCREEN_HEIGHT - (textSize * 8)) / 2 - 5;
+    // ~9 бита на байт по I2C (8 + ACK)
+    float savedMs = (SCREEN_FRAME_BYTES - average) * 9.0f * 1000.0f / i2cClock;
+    Serial.printf("Display: %lu frames at %lu kHz, avg %lu of %d bytes/frame, ~%.1f ms bus time saved/frame\n",
+                  (unsigned long)framesFlushed, (unsigned long)(i2cClock / 1000), (unsigned long)average,
+                  SCREEN_FRAME_BYTES, savedMs);
+}
+
+// ============= NORMAL MODE =============
+
+void DisplayManager::showNormalWeight(float grams, ScaleManager::WeightUnit unit) {
+    display.clearDisplay();
+    display.setTextColor(SSD1306_WHITE);
     
-    display.setTextSize(textSize);
-    display.setCursor(x, y);
-    display.print(weightStr);
+    // Форматиране в буфер на стека, позицията е от кеша по дължина
+    char weightText[16];
+    uint8_t length = formatWeight(weightText, sizeof(weightText), grams, unit);
+    const TextLayout& layout = layouts.weight(length);
+    
+    display.setTextSize(layout.size);
+    display.setCursor(layout.x, layout.y);
+    display.print(weightText);
     
     // Единица долу вдясно
+    const char* suffix = unitFormat(unit).suffix;
     display.setTextSize(1);
-    int unitX = SCREEN_WIDTH - (unit.length() * 6) - 2;
-    int unitY = SCREEN_HEIGHT - 10;
-    display.setCursor(unitX, unitY);
-    display.print(unit);
+    display.setCursor(layouts.rightX(1, strlen(suffix), 2), SCREEN_HEIGHT - 10);
+    display.print(suffix);
     
-    display.display();
+    flush();
 }
 
-void DisplayManager::showUnitChange(String unit) {
+void DisplayManager::showUnitChange(ScaleManager::WeightUnit unit) {
     display.clearDisplay();
-    display.setTextSize(2);
     display.setTextColor(SSD1306_WHITE);
     
-    String fullName;
-    if (unit == "g") fullName = "GRAMS";
-    else if (unit == "kg") fullName = "KILOGRAMS";
-    else if (unit == "oz") fullName = "OUNCES";
-    else if (unit == "lb") fullName = "POUNDS";
-    
-    centerText(fullName, 24, 2);
-    display.display();
+    centerText(unitFormat(unit).name, 24, 2);
+    flush();
     // Махнато delay - loop() ще обнови екрана
 }
 
@@ -119,21 +241,20 @@ void DisplayManager::showDryingLive(DryingSessionManager& drying, float currentW
     display.setTextColor(SSD1306_WHITE);
     
     DryingSession& session = drying.getSession();
+    char line[DISPLAY_MAX_LINE];
     
     // Header - Ден и начално тегло
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.print("DAY ");
-    display.print(session.currentDay);
-    display.print(" | ");
-    display.print((int)session.initialWeight);
-    display.print("g");
+    TextBuilder(line, sizeof(line)).add("DAY ").add((int32_t)session.currentDay)
+        .add(" | ").add((int32_t)session.initialWeight).add("g");
+    display.print(line);
     
     // Текущо тегло (голям шрифт)
     display.setTextSize(2);
     display.setCursor(0, 14);
-    display.print((int)currentWeight);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add((int32_t)currentWeight).add("g");
+    display.print(line);
     
     // Загуба в %
     float lossPercent = drying.getCurrentLossPercent();
@@ -141,8 +262,8 @@ void DisplayManager::showDryingLive(DryingSessionManager& drying, float currentW
     display.setCursor(0, 32);
     display.print("Loss: ");
     display.setTextSize(2);
-    display.print(lossPercent, 1);
-    display.println("%");
+    TextBuilder(line, sizeof(line)).add(lossPercent, 1).add("%");
+    display.print(line);
     
     // Progress bar
     display.setTextSize(1);
@@ -155,11 +276,12 @@ void DisplayManager::showDryingLive(DryingSessionManager& drying, float currentW
     } else {
         int remaining = (int)(session.targetLossPercent - lossPercent);
         if (remaining > 0) {
-            display.print(remaining);
+            TextBuilder(line, sizeof(line)).add((int32_t)remaining);
+            display.print(line);
         }
     }
     
-    display.display();
+    flush();
 }
 
 // ============= DRYING MODE - STATS =============
@@ -171,47 +293,44 @@ void DisplayManager::showDryingStats(DryingSessionManager& drying) {
     
     DryingSession& session = drying.getSession();
     DailyRecord* lastRecord = drying.getLastRecord();
+    char line[DISPLAY_MAX_LINE];
     
     // Title
     display.setCursor(20, 0);
-    display.println("STATISTICS");
+    display.print("STATISTICS");
     
     // Данни
     display.setCursor(0, 12);
-    display.print("Initial: ");
-    display.print(session.initialWeight, 1);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add("Initial: ").add(session.initialWeight, 1).add("g");
+    display.print(line);
     
     if (lastRecord) {
         display.setCursor(0, 22);
-        display.print("Current: ");
-        display.print(lastRecord->weight, 1);
-        display.println("g");
+        TextBuilder(line, sizeof(line)).add("Current: ").add(lastRecord->weight, 1).add("g");
+        display.print(line);
     }
     
     display.setCursor(0, 32);
-    display.print("Target:  -");
-    display.print(session.targetLossPercent, 1);
-    display.println("%");
+    TextBuilder(line, sizeof(line)).add("Target:  -").add(session.targetLossPercent, 1).add("%");
+    display.print(line);
     
     display.setCursor(0, 42);
-    display.print("Status:  -");
-    display.print(drying.getCurrentLossPercent(), 1);
-    display.println("%");
+    TextBuilder(line, sizeof(line)).add("Status:  -").add(drying.getCurrentLossPercent(), 1).add("%");
+    display.print(line);
     
     // Прогноза
     int daysRemaining = drying.estimateDaysRemaining();
     display.setCursor(0, 52);
-    display.print("Remain:  ");
+    TextBuilder remain(line, sizeof(line));
+    remain.add("Remain:  ");
     if (daysRemaining >= 0) {
-        display.print("~");
-        display.print(daysRemaining);
-        display.println(" days");
+        remain.add("~").add((int32_t)daysRemaining).add(" days");
     } else {
-        display.println("N/A");
+        remain.add("N/A");
     }
+    display.print(line);
     
-    display.display();
+    flush();
 }
 
 // ============= DRYING MODE - HISTORY =============
@@ -224,45 +343,97 @@ void DisplayManager::showDryingHistory(DryingSessionManager& drying, int recordI
     DailyRecord* record = drying.getRecord(recordIndex);
     if (!record) {
         centerText("No data", 28);
-        display.display();
+        flush();
         return;
     }
     
-// Header
-display.setCursor(0, 0);
-display.print("DAY ");
-display.print(record->day);
-
-// Последният запис е "Today"
-if (recordIndex == drying.getRecordCount() - 1) {
-    display.print("  (Today)");
-} 
-// Предпоследен е "Yesterday"
-else if (recordIndex == drying.getRecordCount() - 2 && drying.getRecordCount() > 1) {
-    display.print(" (Yesterday)");
-}
+    char line[DISPLAY_MAX_LINE];
+    
+    // Header - последният запис е "Today", предпоследният "Yesterday"
+    TextBuilder header(line, sizeof(line));
+    header.add("DAY ").add((int32_t)record->day);
+    if (recordIndex == drying.getRecordCount() - 1) {
+        header.add("  (Today)");
+    } else if (recordIndex == drying.getRecordCount() - 2 && drying.getRecordCount() > 1) {
+        header.add(" (Yesterday)");
+    }
+    display.setCursor(0, 0);
+    display.print(line);
     
     // Данни
     display.setCursor(0, 16);
-    display.print("Weight: ");
-    display.print(record->weight, 1);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add("Weight: ").add(record->weight, 1).add("g");
+    display.print(line);
     
     display.setCursor(0, 28);
-    display.print("Loss:   ");
-    display.print(record->lossPercent, 1);
-    display.println("%");
+    TextBuilder(line, sizeof(line)).add("Loss:   ").add(record->lossPercent, 1).add("%");
+    display.print(line);
     
     display.setCursor(0, 40);
-    display.print("Change: ");
-    display.print(record->dayChange, 1);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add("Change: ").add(record->dayChange, 1).add("g");
+    display.print(line);
     
     // Навигация
     display.setCursor(10, 54);
     display.print("< PREV    NEXT >");
     
-    display.display();
+    flush();
+}
+
+// ============= DRYING MODE - GRAPH =============
+
+void DisplayManager::showDryingGraph(DryingSessionManager& drying, const Sparkline& day, const Sparkline& loss) {
+    display.clearDisplay();
+    display.setTextColor(SSD1306_WHITE);
+    display.setTextSize(1);
+    
+    DryingSession& session = drying.getSession();
+    char line[DISPLAY_MAX_LINE];
+    float low;
+    float high;
+    
+    // Тегло за 24 ч - скала по min/max, поне 2 g (иначе шумът изглежда голям)
+    TextBuilder header(line, sizeof(line));
+    header.add("24h ");
+    if (day.range(low, high)) {
+        if (high - low < 2.0f) {
+            float middle = (high + low) / 2;
+            low = middle - 1.0f;
+            high = middle + 1.0f;
+        }
+        header.add((int32_t)low).add("-").add((int32_t)high).add("g");
+        drawSparkline(day, 9, 22, low, high);
+    } else {
+        header.add("no data");
+    }
+    display.setCursor(0, 0);
+    display.print(line);
+    
+    // Загуба за сесията - скалата винаги включва целта
+    display.setCursor(0, 33);
+    TextBuilder(line, sizeof(line)).add("Loss ").add(drying.getCurrentLossPercent(), 1)
+        .add("/").add(session.targetLossPercent, 0).add("%");
+    display.print(line);
+    
+    const int plotY = 42;
+    const int plotHeight = 22;
+    high = session.targetLossPercent;
+    if (loss.range(low, high) && high < session.targetLossPercent) {
+        high = session.targetLossPercent;
+    }
+    if (high <= 0) {
+        high = 1.0f;
+    }
+    low = 0.0f;
+    
+    // Целта - пунктир
+    int targetY = plotY + plotHeight - 1 - (int)(session.targetLossPercent / high * (plotHeight - 1));
+    for (int x = 0; x < SCREEN_WIDTH; x += 4) {
+        display.drawPixel(x, targetY, SSD1306_WHITE);
+    }
+    drawSparkline(loss, plotY, plotHeight, low, high);
+    
+    flush();
 }
 
 // ============= CALIBRATION =============
@@ -275,19 +446,20 @@ void DisplayManager::showCalibrationStep1() {
     display.println("Calibration:");
     display.println("Remove weight!");
     display.println("Wait 5 sec...");
-    display.display();
+    flush();
 }
 
 void DisplayManager::showCalibrationStep2(float weight) {
+    char line[DISPLAY_MAX_LINE];
+    
     display.clearDisplay();
     display.setTextSize(1);
     display.setCursor(0, 10);
     display.println("Calibration:");
-    display.print("Hang ");
-    display.print((int)weight);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add("Hang ").add((int32_t)weight).add("g");
+    display.println(line);
     display.println("Wait 10 sec...");
-    display.display();
+    flush();
 }
 
 void DisplayManager::showCalibrationProgress() {
@@ -295,7 +467,7 @@ void DisplayManager::showCalibrationProgress() {
     display.setTextSize(1);
     display.setCursor(20, 28);
     display.println("Calibrating...");
-    display.display();
+    flush();
 }
 
 void DisplayManager::showCalibrationResult(bool success, float error) {
@@ -307,28 +479,29 @@ void DisplayManager::showCalibrationResult(bool success, float error) {
         display.println("  SUCCESSFUL");
         display.println("  calibration!");
     } else {
+        char line[DISPLAY_MAX_LINE];
         display.println("    FAILED");
         display.println("  calibration!");
-        display.print("  Error: ");
-        display.print(error, 1);
-        display.println("%");
+        TextBuilder(line, sizeof(line)).add("  Error: ").add(error, 1).add("%");
+        display.println(line);
     }
     
-    display.display();
+    flush();
 }
 
 // ============= SESSION =============
 
 void DisplayManager::showSessionStart(float initialWeight) {
+    char line[DISPLAY_MAX_LINE];
+    
     display.clearDisplay();
     display.setTextSize(1);
     display.setCursor(0, 16);
     display.println("SESSION STARTED");
-    display.print("Initial: ");
-    display.print((int)initialWeight);
-    display.println("g");
+    TextBuilder(line, sizeof(line)).add("Initial: ").add((int32_t)initialWeight).add("g");
+    display.println(line);
     display.print("Target: -40%");
-    display.display();
+    flush();
 }
 
 void DisplayManager::showSessionEnd() {
@@ -338,38 +511,37 @@ void DisplayManager::showSessionEnd() {
     display.println("SESSION");
     display.setCursor(25, 40);
     display.println("ENDED");
-    display.display();
+    flush();
 }
 
 void DisplayManager::showDailyRecorded(int day, float weight, float lossPercent) {
+    char line[DISPLAY_MAX_LINE];
+    
     display.clearDisplay();
     display.setTextSize(1);
     display.setCursor(0, 10);
-    display.print("DAY ");
-    display.print(day);
-    display.println(" RECORDED");
+    TextBuilder(line, sizeof(line)).add("DAY ").add((int32_t)day).add(" RECORDED");
+    display.println(line);
     display.println();
-    display.print("Weight: ");
-    display.print(weight, 1);
-    display.println("g");
-    display.print("Loss:   ");
-    display.print(lossPercent, 1);
-    display.println("%");
-    display.display();
+    TextBuilder(line, sizeof(line)).add("Weight: ").add(weight, 1).add("g");
+    display.println(line);
+    TextBuilder(line, sizeof(line)).add("Loss:   ").add(lossPercent, 1).add("%");
+    display.println(line);
+    flush();
 }
 
 // ============= HELPERS =============
 
-void DisplayManager::showMessage(String title, String message, int delayMs) {
+void DisplayManager::showMessage(const char* title, const char* message, int delayMs) {
     display.clearDisplay();
     display.setTextSize(1);
     
-    if (title.length() > 0) {
+    if (title[0] != '\0') {
         centerText(title, 16);
     }
     
     centerText(message, 32);
-    display.display();
+    flush();
     
     // Само ако delayMs е зададен за setup съобщения
     if (delayMs > 0) {
@@ -377,14 +549,32 @@ void DisplayManager::showMessage(String title, String message, int delayMs) {
     }
 }
 
-void DisplayManager::centerText(String text, int y, int textSize) {
+void DisplayManager::centerText(const char* text, int y, int textSize) {
     display.setTextSize(textSize);
-    int charWidth = textSize * 6;
-    int x = (SCREEN_WIDTH - (text.length() * charWidth)) / 2;
-    display.setCursor(x, y);
+    display.setCursor(layouts.centeredX(textSize, strlen(text)), y);
     display.print(text);
 }
 
+// Колона на пиксел: вертикална линия от min до max на колоната
+void DisplayManager::drawSparkline(const Sparkline& series, int y, int height, float low, float high) {
+    float scale = (height - 1) / (high - low);
+    int bottom = y + height - 1;
+    float minValue;
+    float maxValue;
+    
+    for (uint8_t x = 0; x < SPARKLINE_COLUMNS && x < SCREEN_WIDTH; x++) {
+        if (!series.column(x, minValue, maxValue)) {
+            continue;
+        }
+        int top = bottom - (int)((maxValue - low) * scale);
+        int base = bottom - (int)((minValue - low) * scale);
+        if (top < y) top = y;
+        if (base > bottom) base = bottom;
+        if (base < top) base = top;
+        display.drawFastVLine(x, top, base - top + 1, SSD1306_WHITE);
+    }
+}
+
 void DisplayManager::drawProgressBar(int x, int y, int width, int height, float percent, float target) {
     // Рамка
     display.drawRect(x, y, width + 2, height, SSD1306_WHITE);
@@ -0,0 +1,175 @@
+#include "Downsampler.h"
+
+Downsampler::Downsampler(Mode mode, uint32_t from, uint32_t to, uint16_t points,
+                         EmitFn emit, void* context) {
+    this->mode = mode;
+    this->from = from;
+    this->to = to < from ? from : to;
+    this->emit = emit;
+    this->context = context;
+
+    // LTTB: първата и последната точка са извън кофите
+    if (mode == MODE_LTTB) {
+        bucketCount = points > 2 ? points - 2 : 0;  // 0 = само първа и последна
+    } else {
+        bucketCount = points > 1 ? points / 2 : 1;
+    }
+
+    resetBucket(pending, -1);
+    resetBucket(current, -1);
+    hasFirst = false;
+    hasHeld = false;
+    inputCount = 0;
+    outputCount = 0;
+}
+
+int32_t Downsampler::bucketOf(uint32_t t) const {
+    uint64_t span = (uint64_t)(to - from) + 1;
+    return (int32_t)((uint64_t)(t - from) * bucketCount / span);
+}
+
+void Downsampler::resetBucket(Bucket& bucket, int32_t index) {
+    bucket.index = index;
+    bucket.count = 0;
+    bucket.sumT = 0.0;
+    bucket.sumV = 0.0;
+}
+
+void Downsampler::addToBucket(Bucket& bucket, const Point& p) {
+    if (bucket.count == 0) {
+        bucket.minPoint = p;
+        bucket.maxPoint = p;
+    } else {
+        if (p.v < bucket.minPoint.v) bucket.minPoint = p;
+        if (p.v > bucket.maxPoint.v) bucket.maxPoint = p;
+    }
+    bucket.count++;
+    bucket.sumT += p.t;
+    bucket.sumV += p.v;
+}
+
+void Downsampler::output(const Point& p) {
+    emit(context, p.t, p.v);
+    outputCount++;
+}
+
+void Downsampler::flushMinMax(const Bucket& bucket) {
+    if (bucket.count == 0) {
+        return;
+    }
+
+    const Point& a = bucket.minPoint.t <= bucket.maxPoint.t ? bucket.minPoint : bucket.maxPoint;
+    const Point& b = bucket.minPoint.t <= bucket.maxPoint.t ? bucket.maxPoint : bucket.minPoint;
+    output(a);
+    if (bucket.count > 1 && (b.t != a.t || b.v != a.v)) {
+        output(b);
+    }
+}
+
+void Downsampler::selectLttb(const Bucket& bucket, double cT, double cV) {
+    if (bucket.count == 0) {
+        return;
+    }
+
+    // Площ на триъгълника (anchor, кандидат, C) - без константата 1/2
+    const Point* candidates[2] = { &bucket.minPoint, &bucket.maxPoint };
+    const Point* best = candidates[0];
+    double bestArea = -1.0;
+
+    for (const Point* p : candidates) {
+        double area = ((double)anchor.t - cT) * ((double)p->v - anchor.v) -
+                      ((double)anchor.t - p->t) * (cV - anchor.v);
+        if (area < 0) area = -area;
+        if (area > bestArea) {
+            bestArea = area;
+            best = p;
+        }
+    }
+
+    output(*best);
+    anchor = *best;
+}
+
+void Downsampler::add(uint32_t t, float value) {
+    if (t < from || t > to) {
+        return;
+    }
+    if (hasFirst && t < last.t) {
+        return;  // Не е подредено по време
+    }
+
+    Point p = { t, value };
+    inputCount++;
+
+    if (mode == MODE_MINMAX) {
+        int32_t index = bucketOf(t);
+        if (index != current.index) {
+            flushMinMax(current);
+            resetBucket(current, index);
+        }
+        addToBucket(current, p);
+        hasFirst = true;
+        last = p;
+        return;
+    }
+
+    // LTTB: първата точка е начална котва, не влиза в кофа
+    if (!hasFirst) {
+        hasFirst = true;
+        last = p;
+        anchor = p;
+        output(p);
+        return;
+    }
+
+    // Задържаната точка влиза в кофата си едва когато дойде следваща,
+    // така че истинската последна точка никога не е в кофа
+    if (hasHeld && bucketCount > 0) {
+        int32_t index = bucketOf(last.t);
+        if (index != current.index) {
+            if (pending.count > 0) {
+                // Кофата след pending е завършена - средното ѝ е известно
+                selectLttb(pending, current.sumT / current.count, current.sumV / current.count);
+            }
+            pending = current;
+            resetBucket(current, index);
+        }
+        addToBucket(current, last);
+    }
+
+    last = p;
+    hasHeld = true;
+}
+
+void Downsampler::finish() {
+    if (!hasFirst) {
+        return;
+    }
+
+    if (mode == MODE_MINMAX) {
+        flushMinMax(current);
+        resetBucket(current, -1);
+        return;
+    }
+
+    if (!hasHeld) {
+        return;  // Само една точка - вече е изпратена
+    }
+
+    // Последните две кофи: pending спрямо current, current спрямо последната точка
+    if (pending.count > 0) {
+        if (current.count > 0) {
+            selectLttb(pending, current.sumT / current.count, current.sumV / current.count);
+        } else {
+            selectLttb(pending, last.t, last.v);
+        }
+    }
+    if (current.count > 0) {
+        selectLttb(current, last.t, last.v);
+    }
+    output(last);
+
+    resetBucket(pending, -1);
+    resetBucket(current, -1);
+    hasHeld = false;
+}
@@ -1,4 +1,6 @@
 #include "DryingSessionManager.h"
+#include <esp_timer.h>
+#include "EventBus.h"
 
 DryingSessionManager::DryingSessionManager(StorageManager& storage) 
     : storage(storage) {
@@ -39,7 +41,7 @@ bool DryingSessionManager::startNewSession(float initialWeight, float targetLoss
     session.isActive = true;
     session.initialWeight = initialWeight;
     session.targetLossPercent = targetLossPercent;
-    session.startTimestamp = millis() / 1000;
+    session.startTimestamp = uptimeSeconds();
     session.lastRecordTimestamp = session.startTimestamp;  // Запази кога е започнал
 
     
@@ -60,6 +62,9 @@ record.dayChange = 0.0f;
 session.recordCount = 1;
 // currentDay вече е 1, не го променяме
     
+    SessionStartedEvent event = { session.startTimestamp, initialWeight, targetLossPercent };
+    EventBus::publish(event);
+    
     // Запазване
     return storage.saveSession(session);
 }
@@ -70,10 +75,44 @@ bool DryingSessionManager::recordDailyWeight(float weight) {
         return false;
     }
     
+    if (session.recordCount >= MAX_DAILY_RECORDS) {
+        Serial.println("[Drying] Max records reached!");
+        return false;
+    }
+    
     Serial.printf("[Drying] Recording Day %d weight: %.1fg\n", session.currentDay, weight);
     
-    // Добавяне чрез StorageManager (той прави изчисленията)
-    return storage.addDailyRecord(session, weight);
+    // Изчисляване на % загуба
+    float totalLoss = session.initialWeight - weight;
+    float lossPercent = (totalLoss / session.initialWeight) * 100.0f;
+    
+    // Изчисляване на промяна от предишния ден
+    float dayChange = 0.0f;
+    if (session.recordCount > 0) {
+        dayChange = session.records[session.recordCount - 1].weight - weight;
+    }
+    
+    // Добавяне на нов запис
+    DailyRecord& record = session.records[session.recordCount];
+    record.day = session.currentDay;
+    record.timestamp = uptimeSeconds();
+    record.weight = weight;
+    record.lossPercent = lossPercent;
+    record.dayChange = dayChange;
+    
+    session.recordCount++;
+    session.currentDay++;
+    session.lastRecordTimestamp = record.timestamp;
+    
+    Serial.printf("[Drying] Day %d recorded: %.1fg, Loss: %.1f%%, Change: %.1fg\n",
+                  record.day, record.weight, record.lossPercent, record.dayChange);
+    
+    RecordAddedEvent event = { record.day, session.recordCount, record.timestamp,
+                               record.weight, record.lossPercent };
+    EventBus::publish(event);
+    
+    // Автоматично запазване
+    return storage.saveSession(session);
 }
 
 void DryingSessionManager::endSession() {
@@ -83,8 +122,12 @@ void DryingSessionManager::endSession() {
     
     session.isActive = false;
     storage.saveSession(session);
+    storage.archiveSession(session);
     
     Serial.println("[Drying] Session ended");
+    
+    SessionEndedEvent event = { session.startTimestamp, session.recordCount, getCurrentLossPercent() };
+    EventBus::publish(event);
 }
 
 bool DryingSessionManager::isActive() {
@@ -138,6 +181,10 @@ int DryingSessionManager::estimateDaysRemaining() {
     return daysRemaining;
 }
 
+float DryingSessionManager::getAverageDailyLoss() {
+    return calculateAverageDailyLoss(3);
+}
+
 bool DryingSessionManager::isReady() {
     if (!session.isActive) {
         return false;
@@ -166,6 +213,10 @@ int DryingSessionManager::getRecordCount() {
     return session.recordCount;
 }
 
+uint32_t DryingSessionManager::uptimeSeconds() {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
 float DryingSessionManager::calculateAverageDailyLoss(int lastNDays) {
     if (session.recordCount < 2 || lastNDays < 1) {
         return 0.0f;
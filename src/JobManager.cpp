@@ -0,0 +1,359 @@
+#include "JobManager.h"
+
+// Таблицата се пипа от HTTP задачата (submit/getJob) и от loop() (update)
+static portMUX_TYPE jobsMux = portMUX_INITIALIZER_UNLOCKED;
+
+JobManager::JobManager() {
+    memset(jobs, 0, sizeof(jobs));
+    nextId = 1;
+    running = -1;
+    phase = 0;
+    phaseStart = 0;
+    sampleCount = 0;
+    sampleSum = 0;
+    calibrationOffset = 0;
+    calibrationFactor = 1.0f;
+    bannerTitle[0] = '\0';
+    bannerMessage[0] = '\0';
+    bannerPending = false;
+}
+
+uint16_t JobManager::submit(JobType type, float param) {
+    uint16_t id = 0;
+
+    portENTER_CRITICAL(&jobsMux);
+
+    // Празен слот или най-старата приключила задача
+    int8_t slot = -1;
+    uint16_t oldestAge = 0;
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].id == 0) {
+            slot = i;
+            break;
+        }
+        if (jobs[i].state == JOB_DONE || jobs[i].state == JOB_FAILED) {
+            uint16_t age = nextId - jobs[i].id;
+            if (age > oldestAge) {
+                oldestAge = age;
+                slot = i;
+            }
+        }
+    }
+
+    if (slot >= 0) {
+        id = nextId++;
+        if (nextId == 0) nextId = 1;
+
+        Job& job = jobs[slot];
+        job.id = id;
+        job.type = type;
+        job.state = JOB_QUEUED;
+        job.progress = 0;
+        job.param = param;
+        strcpy(job.message, "Queued");
+    }
+
+    portEXIT_CRITICAL(&jobsMux);
+
+    if (id == 0) {
+        Serial.println("[Jobs] Queue full");
+    }
+    return id;
+}
+
+bool JobManager::getJob(uint16_t id, Job& out) {
+    bool found = false;
+
+    portENTER_CRITICAL(&jobsMux);
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (id != 0 && jobs[i].id == id) {
+            out = jobs[i];
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&jobsMux);
+
+    return found;
+}
+
+bool JobManager::ownsDisplay() {
+    return running >= 0 && jobs[running].type == JOB_CALIBRATE;
+}
+
+bool JobManager::popBanner(char* title, size_t titleSize, char* message, size_t messageSize) {
+    if (!bannerPending) {
+        return false;
+    }
+    strncpy(title, bannerTitle, titleSize - 1);
+    title[titleSize - 1] = '\0';
+    strncpy(message, bannerMessage, messageSize - 1);
+    message[messageSize - 1] = '\0';
+    bannerPending = false;
+    return true;
+}
+
+const char* JobManager::typeName(JobType type) {
+    switch (type) {
+        case JOB_TARE:          return "tare";
+        case JOB_START_SESSION: return "start";
+        case JOB_STOP_SESSION:  return "stop";
+        case JOB_RECORD_NOW:    return "record";
+        case JOB_CALIBRATE:     return "calibrate";
+        default:                return "unknown";
+    }
+}
+
+const char* JobManager::stateName(JobState state) {
+    switch (state) {
+        case JOB_QUEUED:  return "queued";
+        case JOB_RUNNING: return "running";
+        case JOB_DONE:    return "done";
+        case JOB_FAILED:  return "failed";
+        default:          return "unknown";
+    }
+}
+
+// ============= Изпълнение (само от loop()) =============
+
+int8_t JobManager::findQueued() {
+    // Най-старата чакаща задача - изпълнение по реда на заявките
+    int8_t slot = -1;
+    uint16_t oldestAge = 0;
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].id != 0 && jobs[i].state == JOB_QUEUED) {
+            uint16_t age = nextId - jobs[i].id;
+            if (slot < 0 || age > oldestAge) {
+                oldestAge = age;
+                slot = i;
+            }
+        }
+    }
+    return slot;
+}
+
+void JobManager::setProgress(uint8_t progress, const char* message) {
+    portENTER_CRITICAL(&jobsMux);
+    jobs[running].progress = progress;
+    if (message) {
+        strncpy(jobs[running].message, message, sizeof(jobs[running].message) - 1);
+        jobs[running].message[sizeof(jobs[running].message) - 1] = '\0';
+    }
+    portEXIT_CRITICAL(&jobsMux);
+}
+
+void JobManager::finish(bool ok, const char* message) {
+    portENTER_CRITICAL(&jobsMux);
+    jobs[running].state = ok ? JOB_DONE : JOB_FAILED;
+    jobs[running].progress = 100;
+    strncpy(jobs[running].message, message, sizeof(jobs[running].message) - 1);
+    jobs[running].message[sizeof(jobs[running].message) - 1] = '\0';
+    portEXIT_CRITICAL(&jobsMux);
+
+    Serial.printf("[Jobs] #%u %s: %s\n", jobs[running].id, ok ? "done" : "failed", message);
+    running = -1;
+}
+
+void JobManager::enterPhase(uint8_t next) {
+    phase = next;
+    phaseStart = millis();
+    sampleCount = 0;
+    sampleSum = 0;
+}
+
+void JobManager::setBanner(const char* title, const char* message) {
+    strncpy(bannerTitle, title, sizeof(bannerTitle) - 1);
+    bannerTitle[sizeof(bannerTitle) - 1] = '\0';
+    strncpy(bannerMessage, message, sizeof(bannerMessage) - 1);
+    bannerMessage[sizeof(bannerMessage) - 1] = '\0';
+    bannerPending = true;
+}
+
+bool JobManager::collectSample(ScaleManager& scale, uint8_t target) {
+    long raw;
+    if (sampleCount < target && scale.readRawSample(raw)) {
+        sampleSum += raw;
+        sampleCount++;
+    }
+    return sampleCount >= target;
+}
+
+void JobManager::update(ScaleManager& scale, DryingSessionManager& drying, DisplayManager& display,
+                        ButtonHandler& buttons, float currentWeight) {
+    if (running < 0) {
+        portENTER_CRITICAL(&jobsMux);
+        running = findQueued();
+        if (running >= 0) {
+            jobs[running].state = JOB_RUNNING;
+        }
+        portEXIT_CRITICAL(&jobsMux);
+
+        if (running < 0) {
+            return;
+        }
+
+        // Тара/калибровка по време на сесия изместват нулата - загубата става грешна
+        JobType type = jobs[running].type;
+        if ((type == JOB_TARE || type == JOB_CALIBRATE) && drying.isActive()) {
+            finish(false, "Session active");
+            return;
+        }
+
+        enterPhase(0);
+        Serial.printf("[Jobs] #%u %s started\n", jobs[running].id, typeName(jobs[running].type));
+
+        if (jobs[running].type == JOB_CALIBRATE) {
+            display.showCalibrationStep1();
+        }
+    }
+
+    // type и param не се променят след submit - четат се без заключване
+    Job& job = jobs[running];
+
+    switch (job.type) {
+        case JOB_TARE:
+            runTare(scale);
+            break;
+
+        case JOB_START_SESSION:
+            if (drying.isActive()) {
+                finish(false, "Session already active");
+            } else if (buttons.startSession(scale, drying, display, job.param)) {
+                finish(true, "Session started");
+            } else {
+                finish(false, "Invalid weight");
+            }
+            break;
+
+        case JOB_STOP_SESSION:
+            if (!drying.isActive()) {
+                finish(false, "No active session");
+            } else {
+                buttons.stopSession(drying, display);
+                finish(true, "Session ended");
+            }
+            break;
+
+        case JOB_RECORD_NOW:
+            if (!drying.isActive()) {
+                finish(false, "No active session");
+            } else if (isnan(currentWeight) || !drying.recordDailyWeight(currentWeight)) {
+                finish(false, "Record failed");
+            } else {
+                DailyRecord* record = drying.getLastRecord();
+                char title[16];
+                char message[24];
+                snprintf(title, sizeof(title), "Day %d", record ? record->day : 0);
+                snprintf(message, sizeof(message), "Loss: %.1f%%", record ? record->lossPercent : 0.0f);
+                setBanner(title, message);
+                finish(true, "Recorded");
+            }
+            break;
+
+        case JOB_CALIBRATE:
+            runCalibration(scale, display, job.param);
+            break;
+
+        default:
+            finish(false, "Unknown job");
+            break;
+    }
+}
+
+void JobManager::runTare(ScaleManager& scale) {
+    // Средно от няколко проби, по една на минаване на loop()
+    if (millis() - phaseStart > SAMPLE_TIMEOUT_MS) {
+        finish(false, "Scale not ready");
+        return;
+    }
+    if (!collectSample(scale, TARE_SAMPLES)) {
+        setProgress(sampleCount * 100 / TARE_SAMPLES, "Sampling");
+        return;
+    }
+
+    scale.applyTare((long)(sampleSum / sampleCount));
+    setBanner("", "Tared");
+    finish(true, "Tared");
+}
+
+void JobManager::runCalibration(ScaleManager& scale, DisplayManager& display, float knownWeight) {
+    // Стъпките на ScaleManager::performCalibration(), но без delay()
+    unsigned long elapsed = millis() - phaseStart;
+    bool sampling = phase == CAL_TARE || phase == CAL_LOAD || phase == CAL_VERIFY;
+
+    if (sampling && elapsed > SAMPLE_TIMEOUT_MS) {
+        setBanner("Calibration", "Scale not ready");
+        finish(false, "Scale not ready");
+        return;
+    }
+
+    switch (phase) {
+        case CAL_REMOVE:
+            setProgress(elapsed * 20 / CALIBRATION_REMOVE_MS, "Remove all weight");
+            if (elapsed >= CALIBRATION_REMOVE_MS) {
+                enterPhase(CAL_TARE);
+            }
+            break;
+
+        case CAL_TARE:
+            if (!collectSample(scale, CALIBRATION_SAMPLES)) {
+                setProgress(20 + sampleCount * 20 / CALIBRATION_SAMPLES, "Reading zero");
+                break;
+            }
+            calibrationOffset = (long)(sampleSum / sampleCount);
+            display.showCalibrationStep2(knownWeight);
+            enterPhase(CAL_HANG);
+            break;
+
+        case CAL_HANG:
+            setProgress(40 + elapsed * 30 / CALIBRATION_HANG_MS, "Hang known weight");
+            if (elapsed >= CALIBRATION_HANG_MS) {
+                display.showCalibrationProgress();
+                enterPhase(CAL_LOAD);
+            }
+            break;
+
+        case CAL_LOAD: {
+            if (!collectSample(scale, CALIBRATION_SAMPLES)) {
+                setProgress(70 + sampleCount * 20 / CALIBRATION_SAMPLES, "Reading weight");
+                break;
+            }
+            long difference = (long)(sampleSum / sampleCount) - calibrationOffset;
+            if (difference == 0) {
+                setBanner("Calibration", "No load");
+                finish(false, "No load detected");
+                break;
+            }
+            calibrationFactor = (float)difference / knownWeight;
+            enterPhase(CAL_VERIFY);
+            break;
+        }
+
+        case CAL_VERIFY: {
+            if (!collectSample(scale, CALIBRATION_SAMPLES)) {
+                setProgress(90 + sampleCount * 10 / CALIBRATION_SAMPLES, "Verifying");
+                break;
+            }
+            float testWeight = (float)((long)(sampleSum / sampleCount) - calibrationOffset) / calibrationFactor;
+            float errorPercent = abs(testWeight - knownWeight) / knownWeight * 100.0f;
+            Serial.printf("[Jobs] Calibration test: %.1fg (expected %.1fg), error %.1f%%\n",
+                          testWeight, knownWeight, errorPercent);
+
+            if (errorPercent < CALIBRATION_MAX_ERROR) {
+                scale.applyCalibration(calibrationOffset, calibrationFactor);
+                setBanner("Calibration", "OK");
+                finish(true, "Calibrated");
+            } else {
+                char message[24];
+                snprintf(message, sizeof(message), "Error %.1f%%", errorPercent);
+                setBanner("Calibration", message);
+                finish(false, "Error above 5%");
+            }
+            break;
+        }
+
+        default:
+            finish(false, "Bad phase");
+            break;
+    }
+}
@@ -0,0 +1,223 @@
+#include "JsonWriter.h"
+#include <string.h>
+
+// 10^n за бързото форматиране на float (до 6 знака след точката)
+static const uint32_t POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+static const uint8_t MAX_DECIMALS = 6;
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity) {
+    buf = buffer;
+    cap = capacity;
+    reset();
+}
+
+void JsonWriter::reset() {
+    len = 0;
+    overflow = (cap == 0);
+    hasItems = 0;
+    depth = 0;
+    afterKey = false;
+    if (cap > 0) {
+        buf[0] = '\0';
+    }
+}
+
+void JsonWriter::put(char c) {
+    // Винаги пазим място за терминиращата нула
+    if (len + 1 >= cap) {
+        overflow = true;
+        return;
+    }
+    buf[len++] = c;
+    buf[len] = '\0';
+}
+
+void JsonWriter::put(const char* s, size_t n) {
+    if (len + n >= cap) {
+        overflow = true;
+        n = (cap > len + 1) ? cap - len - 1 : 0;
+    }
+    memcpy(buf + len, s, n);
+    len += n;
+    if (cap > 0) {
+        buf[len] = '\0';
+    }
+}
+
+void JsonWriter::putUnsigned(uint64_t v) {
+    // Цифрите се пишат отзад напред
+    char digits[20];
+    uint8_t pos = sizeof(digits);
+    while (v > 0xFFFFFFFFULL) {
+        digits[--pos] = '0' + (v % 10);
+        v /= 10;
+    }
+    // 32-битово деление е много по-евтино (на ESP32 - хардуерно)
+    uint32_t small = (uint32_t)v;
+    do {
+        digits[--pos] = '0' + (small % 10);
+        small /= 10;
+    } while (small > 0);
+    put(digits + pos, sizeof(digits) - pos);
+}
+
+void JsonWriter::separator() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth > 0) {
+        uint32_t bit = 1UL << (depth - 1);
+        if (hasItems & bit) {
+            put(',');
+        }
+        hasItems |= bit;
+    }
+}
+
+void JsonWriter::open(char c) {
+    separator();
+    put(c);
+    if (depth < 32) {
+        depth++;
+        hasItems &= ~(1UL << (depth - 1));
+    } else {
+        overflow = true;
+    }
+}
+
+void JsonWriter::close(char c) {
+    if (depth > 0) {
+        depth--;
+    }
+    put(c);
+}
+
+JsonWriter& JsonWriter::beginObject() { open('{'); return *this; }
+JsonWriter& JsonWriter::endObject() { close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray() { open('['); return *this; }
+JsonWriter& JsonWriter::endArray() { close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(const char* name) {
+    separator();
+    putString(name);
+    put(':');
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+    separator();
+    if (v) put("true", 4);
+    else put("false", 5);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int32_t v) {
+    separator();
+    if (v < 0) {
+        put('-');
+        putUnsigned((uint64_t)(-(int64_t)v));
+    } else {
+        putUnsigned((uint64_t)v);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(uint32_t v) {
+    separator();
+    putUnsigned(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(float v, uint8_t decimals) {
+    separator();
+
+    if (decimals > MAX_DECIMALS) {
+        decimals = MAX_DECIMALS;
+    }
+
+    // Целочислено форматиране: закръгляне към 10^-decimals, без printf/dtoa
+    uint32_t scale = POW10[decimals];
+    bool negative = v < 0;
+    float magnitude = negative ? -v : v;
+
+    // NaN/Inf не са валиден JSON; стойност, която не се събира в uint64_t
+    // след мащабирането (над ~1.8e13 при 6 знака) - също null
+    if (!((double)magnitude * scale < 1.8e19)) {
+        put("null", 4);
+        return *this;
+    }
+    uint64_t fixed;
+    if (magnitude * scale < 8388608.0f) {
+        // Точно във float (2^23) - ESP32 има FPU само за float
+        fixed = (uint64_t)(magnitude * scale + 0.5f);
+    } else {
+        fixed = (uint64_t)((double)magnitude * scale + 0.5);
+    }
+
+    if (negative && fixed != 0) {
+        put('-');
+    }
+
+    putUnsigned(fixed / scale);
+
+    if (decimals > 0) {
+        char frac[MAX_DECIMALS + 1];
+        uint64_t rest = fixed % scale;
+        frac[0] = '.';
+        for (int8_t i = decimals; i > 0; i--) {
+            frac[i] = '0' + (rest % 10);
+            rest /= 10;
+        }
+        put(frac, decimals + 1);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* v) {
+    separator();
+    if (!v) {
+        put("null", 4);
+        return *this;
+    }
+    putString(v);
+    return *this;
+}
+
+void JsonWriter::putString(const char* v) {
+    put('"');
+    const char* start = v;
+    for (const char* p = v; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+
+        // Екраниране - пишем натрупаното до момента
+        put(start, p - start);
+        start = p + 1;
+
+        switch (c) {
+            case '"':  put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\t': put("\\t", 2); break;
+            default: {
+                static const char HEX_DIGITS[] = "0123456789abcdef";
+                char esc[6] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F] };
+                put(esc, 6);
+                break;
+            }
+        }
+    }
+    put(start, strlen(start));
+    put('"');
+}
+
+JsonWriter& JsonWriter::null() {
+    separator();
+    put("null", 4);
+    return *this;
+}
@@ -0,0 +1,231 @@
+#include "Metrics.h"
+#include <string.h>
+
+FirmwareMetrics metrics;
+
+// Граници на кофите
+static const uint32_t LOOP_TIME_BOUNDS_US[] = { 100, 500, 1000, 5000, 10000, 50000, 100000, 500000 };
+static const uint32_t JITTER_BOUNDS_MS[] = { 1, 5, 10, 20, 50, 100, 500, 1000 };
+static const uint32_t DISPLAY_FLUSH_BOUNDS_US[] = { 500, 1000, 2500, 5000, 10000, 25000, 50000 };
+static const uint32_t HTTP_LATENCY_BOUNDS_US[] = { 500, 1000, 5000, 10000, 50000, 100000, 500000 };
+
+static const char* const ROUTE_NAMES[ROUTE_COUNT] = {
+    "/",
+    "/history",
+    "/status/data",
+    "/history/data",
+    "/history/sessions",
+    "/series",
+    "/metrics",
+    "/api/control",
+    "/api/jobs",
+    "/trace"
+};
+
+const char* httpRouteName(HttpRoute route) {
+    return route < ROUTE_COUNT ? ROUTE_NAMES[route] : "?";
+}
+
+MetricHistogram::MetricHistogram() : count(0), sum(0) {
+    bounds = nullptr;
+    boundCount = 0;
+    for (uint8_t i = 0; i <= METRICS_MAX_BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::init(const uint32_t* bounds, uint8_t count) {
+    this->bounds = bounds;
+    boundCount = count > METRICS_MAX_BUCKETS ? METRICS_MAX_BUCKETS : count;
+}
+
+void MetricHistogram::observe(uint32_t value) {
+    uint8_t i = 0;
+    while (i < boundCount && value > bounds[i]) {
+        i++;
+    }
+    buckets[i].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+FirmwareMetrics::FirmwareMetrics() {
+    loopTimeUs.init(LOOP_TIME_BOUNDS_US, sizeof(LOOP_TIME_BOUNDS_US) / sizeof(uint32_t));
+    samplingJitterMs.init(JITTER_BOUNDS_MS, sizeof(JITTER_BOUNDS_MS) / sizeof(uint32_t));
+    displayFlushUs.init(DISPLAY_FLUSH_BOUNDS_US, sizeof(DISPLAY_FLUSH_BOUNDS_US) / sizeof(uint32_t));
+    for (uint8_t i = 0; i < ROUTE_COUNT; i++) {
+        httpLatencyUs[i].init(HTTP_LATENCY_BOUNDS_US, sizeof(HTTP_LATENCY_BOUNDS_US) / sizeof(uint32_t));
+    }
+}
+
+// ============= Експозиция =============
+
+namespace {
+
+// Минимален писач на текст в буфер - без printf, без heap
+class TextWriter {
+public:
+    TextWriter(char* buffer, size_t size) : buf(buffer), cap(size), len(0), overflow(size == 0) {
+        if (size > 0) buf[0] = '\0';
+    }
+
+    TextWriter& put(const char* s) {
+        size_t n = strlen(s);
+        if (overflow || len + n >= cap) {
+            overflow = true;
+            return *this;
+        }
+        memcpy(buf + len, s, n);
+        len += n;
+        buf[len] = '\0';
+        return *this;
+    }
+
+    TextWriter& put(uint32_t v) {
+        char tmp[11];
+        char* p = tmp + sizeof(tmp);
+        *--p = '\0';
+        do {
+            *--p = '0' + (v % 10);
+            v /= 10;
+        } while (v > 0);
+        return put(p);
+    }
+
+    TextWriter& put(int32_t v) {
+        if (v < 0) {
+            put("-");
+            return put((uint32_t)(-(int64_t)v));
+        }
+        return put((uint32_t)v);
+    }
+
+    size_t length() const { return overflow ? 0 : len; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+};
+
+void header(TextWriter& out, const char* name, const char* type, const char* help) {
+    out.put("# HELP ").put(name).put(" ").put(help).put("\n");
+    out.put("# TYPE ").put(name).put(" ").put(type).put("\n");
+}
+
+void counter(TextWriter& out, const char* name, const char* help, uint32_t value) {
+    header(out, name, "counter", help);
+    out.put(name).put(" ").put(value).put("\n");
+}
+
+void gauge(TextWriter& out, const char* name, const char* help, int32_t value) {
+    header(out, name, "gauge", help);
+    out.put(name).put(" ").put(value).put("\n");
+}
+
+void gauge(TextWriter& out, const char* name, const char* help, uint32_t value) {
+    header(out, name, "gauge", help);
+    out.put(name).put(" ").put(value).put("\n");
+}
+
+// label може да е nullptr; иначе е готово 'route="/x"'
+void histogramSeries(TextWriter& out, const char* name, const char* label, const MetricHistogram& h) {
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i <= h.getBoundCount(); i++) {
+        cumulative += h.getBucket(i);
+        out.put(name).put("_bucket{");
+        if (label) out.put(label).put(",");
+        out.put("le=\"");
+        if (i < h.getBoundCount()) {
+            out.put(h.getBound(i));
+        } else {
+            out.put("+Inf");
+        }
+        out.put("\"} ").put(cumulative).put("\n");
+    }
+
+    out.put(name).put("_sum");
+    if (label) out.put("{").put(label).put("}");
+    out.put(" ").put(h.getSum()).put("\n");
+
+    out.put(name).put("_count");
+    if (label) out.put("{").put(label).put("}");
+    out.put(" ").put(h.getCount()).put("\n");
+}
+
+void routeLabel(TextWriter& out, uint8_t route) {
+    out.put("route=\"").put(ROUTE_NAMES[route]).put("\"");
+}
+
+// name{task="x",core="1",priority="5"} и интервал преди стойността
+void taskLabel(TextWriter& out, const char* name, const MetricsTask& task) {
+    out.put(name).put("{task=\"").put(task.name);
+    out.put("\",core=\"").put((uint32_t)task.core);
+    out.put("\",priority=\"").put((uint32_t)task.priority).put("\"} ");
+}
+
+}  // namespace
+
+size_t writeMetrics(char* buffer, size_t size, const FirmwareMetrics& m, const MetricsGauges& g) {
+    TextWriter out(buffer, size);
+
+    gauge(out, "scale_uptime_seconds", "Seconds since boot.", g.uptimeSec);
+    gauge(out, "scale_boot_to_first_sample_milliseconds", "Time from boot to the first valid HX711 sample (0 = none yet).", m.bootToFirstSampleMs.get());
+    gauge(out, "scale_boot_to_wifi_milliseconds", "Time from boot to the first WiFi IP (0 = not connected yet).", m.bootToWifiMs.get());
+
+    header(out, "scale_loop_duration_microseconds", "histogram", "Duration of one loop() pass, excluding the wait for the next sample.");
+    histogramSeries(out, "scale_loop_duration_microseconds", nullptr, m.loopTimeUs);
+
+    counter(out, "scale_hx711_samples_read_total", "HX711 samples read successfully.", m.scaleSamplesRead.get());
+    counter(out, "scale_hx711_samples_dropped_total", "HX711 sample slots with no valid reading, or samples overwritten before loop() took them.", m.scaleSamplesDropped.get());
+
+    header(out, "scale_sampling_jitter_milliseconds", "histogram", "Deviation of the weight sampling interval from its target.");
+    histogramSeries(out, "scale_sampling_jitter_milliseconds", nullptr, m.samplingJitterMs);
+
+    header(out, "scale_http_requests_total", "counter", "HTTP requests handled, by route.");
+    for (uint8_t i = 0; i < ROUTE_COUNT; i++) {
+        out.put("scale_http_requests_total{");
+        routeLabel(out, i);
+        out.put("} ").put(m.httpRequests[i].get()).put("\n");
+    }
+
+    header(out, "scale_http_handler_duration_microseconds", "histogram", "Time spent in the HTTP handler, by route.");
+    for (uint8_t i = 0; i < ROUTE_COUNT; i++) {
+        char label[40];
+        TextWriter labelOut(label, sizeof(label));
+        routeLabel(labelOut, i);
+        histogramSeries(out, "scale_http_handler_duration_microseconds", label, m.httpLatencyUs[i]);
+    }
+
+    counter(out, "scale_http_rejected_total", "HTTP requests rejected with 503 (too many in flight).", m.httpRejected.get());
+    counter(out, "scale_json_bytes_total", "JSON bytes produced for HTTP responses and SSE events.", m.jsonBytes.get());
+    counter(out, "scale_littlefs_bytes_written_total", "Bytes written to LittleFS.", m.fsBytesWritten.get());
+    counter(out, "scale_nvs_writes_total", "NVS (Preferences) put operations.", m.nvsWrites.get());
+
+    header(out, "scale_display_flush_microseconds", "histogram", "Time to send one OLED frame (changed pages only).");
+    histogramSeries(out, "scale_display_flush_microseconds", nullptr, m.displayFlushUs);
+    counter(out, "scale_display_bytes_sent_total", "OLED data bytes sent over I2C.", m.displayBytesSent.get());
+    counter(out, "scale_display_bytes_saved_total", "OLED data bytes skipped because their page/columns did not change.", m.displayBytesSaved.get());
+
+    gauge(out, "scale_heap_free_bytes", "Free heap.", g.freeHeap);
+    gauge(out, "scale_heap_min_free_bytes", "Lowest free heap since boot.", g.minFreeHeap);
+    gauge(out, "scale_heap_largest_free_block_bytes", "Largest allocatable heap block.", g.largestFreeBlock);
+
+    gauge(out, "scale_wifi_connected", "1 when the WiFi station is connected.", (uint32_t)(g.wifiConnected ? 1 : 0));
+    gauge(out, "scale_wifi_rssi_dbm", "WiFi signal strength.", g.wifiRssi);
+    counter(out, "scale_wifi_reconnects_total", "WiFi reconnections after the first connect.", m.wifiReconnects.get());
+
+    header(out, "scale_task_cpu_milliseconds_total", "counter", "Time each firmware task spent working (not blocked).");
+    for (uint8_t i = 0; i < g.taskCount; i++) {
+        taskLabel(out, "scale_task_cpu_milliseconds_total", g.tasks[i]);
+        out.put(g.tasks[i].cpuMs).put("\n");
+    }
+    header(out, "scale_task_stack_free_bytes", "gauge", "Lowest free stack of each task since boot (high-water mark).");
+    for (uint8_t i = 0; i < g.taskCount; i++) {
+        taskLabel(out, "scale_task_stack_free_bytes", g.tasks[i]);
+        out.put(g.tasks[i].stackFreeBytes).put("\n");
+    }
+
+    return out.length();
+}
@@ -0,0 +1,269 @@
+#include "MicroBench.h"
+#include "Trace.h"
+
+// Резултатът се пази, за да не изхвърли компилаторът изчислението
+static volatile float benchSink = 0.0f;
+
+static const uint16_t BENCH_SIZES[] = { 1, 60, 1000 };
+static const uint32_t BENCH_SAMPLE_MS = 500;       // Като Sampler
+static const float BENCH_INITIAL_WEIGHT = 5000.0f;
+
+MicroBench::MicroBench(ScaleManager& scale, StorageManager& storage, DisplayManager& display)
+    : scale(scale), storage(storage), display(display), drying(storage),
+      dayGraph(Sparkline::MODE_WINDOW, 24UL * 3600),
+      lossGraph(Sparkline::MODE_SESSION, 60) {
+    resultCount = 0;
+}
+
+// MICROBENCH_ROUNDS кръга по iterations операции; 32-битовият брояч
+// стига за ~17 s кръг при 240 MHz
+template <typename F>
+void MicroBench::measure(const char* name, uint16_t size, uint32_t iterations, F operation) {
+    if (resultCount >= MICROBENCH_MAX_RESULTS) {
+        return;
+    }
+
+    uint32_t bytes = operation();   // Загряване (кеш на флаша, първи запис)
+    uint32_t best = UINT32_MAX;
+    uint64_t total = 0;
+
+    for (uint8_t round = 0; round < MICROBENCH_ROUNDS; round++) {
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < iterations; i++) {
+            bytes = operation();
+        }
+        uint32_t cycles = ESP.getCycleCount() - start;
+        if (cycles < best) best = cycles;
+        total += cycles;
+    }
+
+    BenchResult& result = results[resultCount++];
+    result.name = name;
+    result.size = size;
+    result.iterations = iterations;
+    result.bestCycles = best / iterations;
+    result.meanCycles = (uint32_t)(total / ((uint64_t)iterations * MICROBENCH_ROUNDS));
+    result.bytes = bytes;
+}
+
+void MicroBench::run() {
+    resultCount = 0;
+    benchSamplePath();
+    benchJson();
+    benchStorage();
+    benchDisplay();
+}
+
+// Сесия с records дневни записа, загуба ~1.2% на ден
+void MicroBench::fillSession(uint8_t records) {
+    DryingSession& session = drying.getSession();
+    memset(&session, 0, sizeof(session));
+    session.isActive = true;
+    session.initialWeight = BENCH_INITIAL_WEIGHT;
+    session.targetLossPercent = 40.0f;
+    session.startTimestamp = 1000;
+
+    float weight = BENCH_INITIAL_WEIGHT;
+    for (uint8_t i = 0; i < records; i++) {
+        float change = weight * 0.012f;
+        weight -= change;
+        DailyRecord& record = session.records[i];
+        record.day = i + 1;
+        record.timestamp = session.startTimestamp + i * 86400UL;
+        record.weight = weight;
+        record.lossPercent = (BENCH_INITIAL_WEIGHT - weight) / BENCH_INITIAL_WEIGHT * 100.0f;
+        record.dayChange = change;
+    }
+    session.recordCount = records;
+    session.currentDay = records;
+    session.lastRecordTimestamp = records > 0 ? session.records[records - 1].timestamp : 0;
+}
+
+// Графиките за екрана: samples проби, разпределени в последните 24 ч
+void MicroBench::fillGraphs(uint16_t samples) {
+    const uint32_t now = 10UL * 86400;
+    uint32_t step = 86400UL / samples;
+    dayGraph.reset();
+    lossGraph.reset(now - 86400);
+    for (uint16_t i = 0; i < samples; i++) {
+        uint32_t t = now - 86400 + (i + 1) * step;
+        float weight = BENCH_INITIAL_WEIGHT - i * 0.5f;
+        dayGraph.add(t, weight);
+        lossGraph.add(t, (BENCH_INITIAL_WEIGHT - weight) / BENCH_INITIAL_WEIGHT * 100.0f);
+    }
+}
+
+// ============= Проба =============
+
+void MicroBench::benchSamplePath() {
+    // Абонатите на WeightSampleEvent без AlertManager: стабилност,
+    // минутен лог и двете графики. size = проби на операция.
+    uint32_t timeMs = 0;
+    for (uint16_t size : BENCH_SIZES) {
+        measure("sample_path", size, 20000 / size, [&]() -> uint32_t {
+            for (uint16_t i = 0; i < size; i++) {
+                timeMs += BENCH_SAMPLE_MS;
+                float weight = BENCH_INITIAL_WEIGHT - (timeMs / 1000) * 0.001f + (i & 3) * 0.2f;
+                stability.add(weight);
+                log.addReading(timeMs / 1000, weight);
+                dayGraph.add(timeMs / 1000, weight);
+                lossGraph.add(timeMs / 1000, (BENCH_INITIAL_WEIGHT - weight) / BENCH_INITIAL_WEIGHT * 100.0f);
+            }
+            benchSink = benchSink + (stability.isStable() ? 1.0f : 0.0f);
+            return 0;
+        });
+    }
+
+    for (uint16_t size : BENCH_SIZES) {
+        measure("convert_weight", size, 20000 / size, [&]() -> uint32_t {
+            float sum = 0.0f;
+            for (uint16_t i = 0; i < size; i++) {
+                sum += scale.convertWeight(BENCH_INITIAL_WEIGHT - i);
+            }
+            benchSink = sum;
+            return 0;
+        });
+    }
+
+    // Цената на двойка маркери начало/край (пълни ring buffer-а на Trace)
+    measure("trace_scope", 1, 20000, [&]() -> uint32_t {
+        TRACE_SCOPE("bench");
+        return 0;
+    });
+}
+
+// ============= JSON =============
+
+static void readBenchSample(void* context, uint16_t index, uint32_t& t, float& value) {
+    WeightSample sample = static_cast<SampleLog*>(context)->at(index);
+    t = sample.timestamp;
+    value = sample.weight;
+}
+
+// Генерирането на отговора без кеша на ApiHandler (getStatusJSON /
+// getHistoryJSON при ново поколение). Сесията е до MAX_DAILY_RECORDS
+// записа - 1000 има само в минутния лог (/series).
+void MicroBench::benchJson() {
+    static const uint8_t recordSizes[] = { 1, MAX_DAILY_RECORDS };
+
+    for (uint8_t records : recordSizes) {
+        fillSession(records);
+        StatusSnapshot snap;
+        snap.active = true;
+        snap.initialWeight = BENCH_INITIAL_WEIGHT;
+        snap.currentWeight = drying.getLastRecord()->weight;
+        snap.targetLoss = 40.0f;
+        snap.currentDay = records;
+        snap.recordCount = records;
+        snap.daysRemaining = drying.estimateDaysRemaining();
+        snap.isReady = drying.isReady();
+
+        measure("status_json", records, 1000, [&]() -> uint32_t {
+            JsonWriter writer(json, sizeof(json));
+            writeStatusJson(writer, snap);
+            return writer.length();
+        });
+    }
+
+    for (uint8_t records : recordSizes) {
+        fillSession(records);
+        const DryingSession& session = drying.getSession();
+        bool sorted = timestampsSorted(session.records, session.recordCount);
+        measure("history_json", records, records == 1 ? 1000 : 100, [&]() -> uint32_t {
+            JsonWriter writer(json, sizeof(json));
+            writeHistoryJson(writer, true, 0, session.startTimestamp, session.records,
+                             session.recordCount, sorted, HistoryQuery());
+            return writer.overflowed() ? 0 : writer.length();
+        });
+    }
+
+    // Минутни проби (24 ч лог), намалени до точките по подразбиране
+    for (uint16_t size : BENCH_SIZES) {
+        log.clear();
+        for (uint16_t i = 0; i <= size; i++) {
+            log.addReading(i * SAMPLE_LOG_INTERVAL, BENCH_INITIAL_WEIGHT - i * 0.1f);
+        }
+        SeriesQuery query;
+        measure("series_json", size, size == 1000 ? 20 : 200, [&]() -> uint32_t {
+            JsonWriter writer(json, sizeof(json));
+            writeSeriesJson(writer, "samples", query, log.size(), readBenchSample, &log);
+            return writer.overflowed() ? 0 : writer.length();
+        });
+    }
+}
+
+// ============= LittleFS =============
+
+// Собствени файлове - задачата за запис може да пише /session.json и
+// /records.json по същото време, а записаната сесия трябва да остане
+static const char* BENCH_SESSION_FILE = "/bench_session.json";
+static const char* BENCH_RECORDS_FILE = "/bench_records.json";
+
+// Синхронният запис (writeSession), който задачата за запис прави на
+// всеки saveSession(); loop() плаща само копието на сесията
+void MicroBench::benchStorage() {
+    static const uint8_t recordSizes[] = { 1, MAX_DAILY_RECORDS };
+
+    for (uint8_t records : recordSizes) {
+        fillSession(records);
+        const DryingSession& session = drying.getSession();
+        measure("save_session", records, 10, [&]() -> uint32_t {
+            storage.writeSession(session, BENCH_SESSION_FILE, BENCH_RECORDS_FILE);
+            return 0;
+        });
+        measure("load_session", records, 10, [&]() -> uint32_t {
+            DryingSession loaded;
+            storage.loadSession(loaded, BENCH_SESSION_FILE, BENCH_RECORDS_FILE);
+            return 0;
+        });
+    }
+    storage.removeSession(BENCH_SESSION_FILE, BENCH_RECORDS_FILE);
+}
+
+// ============= OLED =============
+
+// Съставяне на кадъра в буфера на Adafruit и копието за задачата на
+// дисплея; изпращането по I2C е в задачата и не влиза
+void MicroBench::benchDisplay() {
+    static const uint8_t recordSizes[] = { 1, MAX_DAILY_RECORDS };
+
+    for (uint8_t records : recordSizes) {
+        fillSession(records);
+        measure("oled_stats", records, 100, [&]() -> uint32_t {
+            display.showDryingStats(drying);
+            return 0;
+        });
+    }
+
+    fillSession(MAX_DAILY_RECORDS);
+    for (uint16_t size : BENCH_SIZES) {
+        fillGraphs(size);
+        measure("oled_graph", size, 100, [&]() -> uint32_t {
+            display.showDryingGraph(drying, dayGraph, lossGraph);
+            return 0;
+        });
+    }
+}
+
+// ============= Изход =============
+
+void MicroBench::printJson(Print& out) const {
+    char line[160];
+    uint32_t mhz = ESP.getCpuFreqMHz();
+
+    snprintf(line, sizeof(line), "{\"target\":\"%s\",\"cpu_mhz\":%u,\"rounds\":%u,\"results\":[\n",
+             ESP.getChipModel(), (unsigned)mhz, (unsigned)MICROBENCH_ROUNDS);
+    out.print(line);
+
+    for (uint8_t i = 0; i < resultCount; i++) {
+        const BenchResult& r = results[i];
+        snprintf(line, sizeof(line),
+                 "{\"case\":\"%s\",\"n\":%u,\"iterations\":%u,\"best_cycles\":%u,"
+                 "\"mean_cycles\":%u,\"best_ns\":%.1f,\"bytes\":%u}%s\n",
+                 r.name, (unsigned)r.size, (unsigned)r.iterations, (unsigned)r.bestCycles,
+                 (unsigned)r.meanCycles, r.bestCycles * 1000.0 / mhz, (unsigned)r.bytes,
+                 i + 1 < resultCount ? "," : "");
+        out.print(line);
+    }
+    out.print("]}\n");
+}
@@ -0,0 +1,162 @@
+#include "NetworkManager.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+
+std::atomic<uint8_t> NetworkManager::pendingEvents(0);
+std::atomic<uint8_t> NetworkManager::lastReason(0);
+
+NetworkManager::NetworkManager() {
+    ssid = "";
+    password = "";
+    state = NET_IDLE;
+    attemptStart = 0;
+    retryAt = 0;
+    backoffMs = BACKOFF_MIN_MS;
+    attempt = 0;
+    everConnected = false;
+    connectedWork = nullptr;
+    connectedContext = nullptr;
+    taskHandle = nullptr;
+    monitorId = -1;
+}
+
+// Вика се от задачата на WiFi драйвера - само флагове, без логика
+void NetworkManager::onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            pendingEvents.fetch_or(EVENT_GOT_IP);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            lastReason.store(info.wifi_sta_disconnected.reason);
+            pendingEvents.fetch_or(EVENT_DISCONNECTED);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            pendingEvents.fetch_or(EVENT_DISCONNECTED);
+            break;
+        default:
+            break;
+    }
+}
+
+void NetworkManager::setConnectedWork(Work work, void* context) {
+    connectedWork = work;
+    connectedContext = context;
+}
+
+void NetworkManager::begin(const char* ssid, const char* password) {
+    this->ssid = ssid;
+    this->password = password;
+
+    Serial.printf("[Network] SSID: %s\n", ssid);
+
+    // Повторното свързване е наше (с backoff), не на драйвера
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(onWiFiEvent);
+
+    startAttempt();
+
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, this,
+                            NETWORK_TASK_PRIORITY, &taskHandle, NETWORK_TASK_CORE);
+    monitorId = taskMonitor.add("network", taskHandle, NETWORK_TASK_CORE, NETWORK_TASK_PRIORITY);
+}
+
+void NetworkManager::networkTask(void* context) {
+    static_cast<NetworkManager*>(context)->runTask();
+}
+
+void NetworkManager::runTask() {
+    for (;;) {
+        {
+            TaskBusy busy(monitorId);
+            update();
+            if (connectedWork && isConnected()) {
+                connectedWork(connectedContext);
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(NETWORK_TASK_PERIOD_MS));
+    }
+}
+
+void NetworkManager::startAttempt() {
+    attempt++;
+    attemptStart = millis();
+    state = NET_CONNECTING;
+
+    Serial.printf("[Network] Connecting (attempt %u)...\n", attempt);
+    WiFi.begin(ssid, password);
+}
+
+void NetworkManager::enterBackoff(const char* why) {
+    // Случайни +0..25%, за да не се синхронизират няколко устройства
+    unsigned long delayMs = backoffMs + esp_random() % (backoffMs / 4 + 1);
+    retryAt = millis() + delayMs;
+    state = NET_BACKOFF;
+
+    Serial.printf("[Network] %s, retry in %lu ms\n", why, delayMs);
+
+    backoffMs = backoffMs * 2 > BACKOFF_MAX_MS ? BACKOFF_MAX_MS : backoffMs * 2;
+}
+
+void NetworkManager::update() {
+    unsigned long now = millis();
+    uint8_t events = pendingEvents.exchange(0);
+
+    // Флаговете казват "нещо стана"; реалното състояние е WiFi.status()
+    if (events & EVENT_GOT_IP) {
+        if (WiFi.status() == WL_CONNECTED && state != NET_CONNECTED) {
+            state = NET_CONNECTED;
+            backoffMs = BACKOFF_MIN_MS;
+
+            if (everConnected) {
+                metrics.wifiReconnects.inc();
+            } else {
+                metrics.bootToWifiMs.set(now);
+            }
+            everConnected = true;
+
+            Serial.printf("[Network] Connected, IP: %s, RSSI: %d dBm\n",
+                          WiFi.localIP().toString().c_str(), WiFi.RSSI());
+            return;
+        }
+    }
+
+    if (events & EVENT_DISCONNECTED) {
+        if (state == NET_CONNECTED) {
+            WiFi.disconnect();
+            char why[32];
+            snprintf(why, sizeof(why), "Disconnected (reason %u)", lastReason.load());
+            enterBackoff(why);
+            return;
+        }
+        if (state == NET_CONNECTING && now - attemptStart > STALE_EVENT_MS) {
+            char why[32];
+            snprintf(why, sizeof(why), "Failed (reason %u)", lastReason.load());
+            enterBackoff(why);
+            return;
+        }
+    }
+
+    switch (state) {
+        case NET_CONNECTING:
+            if (now - attemptStart >= CONNECT_TIMEOUT_MS) {
+                WiFi.disconnect();
+                enterBackoff("Connect timeout");
+            }
+            break;
+
+        case NET_BACKOFF:
+            if ((long)(now - retryAt) >= 0) {
+                startAttempt();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+String NetworkManager::getIPAddress() {
+    return WiFi.localIP().toString();
+}
@@ -0,0 +1,70 @@
+#include "SampleLog.h"
+#include <math.h>
+
+SampleLog::SampleLog() : sequence(0) {
+    head = 0;
+    count = 0;
+    bucketStart = 0;
+    bucketSum = 0.0f;
+    bucketCount = 0;
+}
+
+void SampleLog::addReading(uint32_t timestamp, float weight) {
+    if (isnan(weight)) {
+        return;
+    }
+
+    uint32_t minute = timestamp - (timestamp % SAMPLE_LOG_INTERVAL);
+
+    // Нова минута - записваме средното на предишната
+    if (bucketCount > 0 && minute != bucketStart) {
+        push(bucketStart, bucketSum / bucketCount);
+        bucketSum = 0.0f;
+        bucketCount = 0;
+    }
+
+    if (bucketCount == 0) {
+        bucketStart = minute;
+    }
+    bucketSum += weight;
+    bucketCount++;
+}
+
+void SampleLog::clear() {
+    sequence.fetch_add(1, std::memory_order_acq_rel);
+    head = 0;
+    count = 0;
+    bucketSum = 0.0f;
+    bucketCount = 0;
+    sequence.fetch_add(1, std::memory_order_release);
+}
+
+void SampleLog::push(uint32_t timestamp, float weight) {
+    sequence.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    samples[head].timestamp = timestamp;
+    samples[head].weight = weight;
+    head = (head + 1) % SAMPLE_LOG_CAPACITY;
+    if (count < SAMPLE_LOG_CAPACITY) {
+        count++;
+    }
+
+    sequence.fetch_add(1, std::memory_order_release);
+}
+
+WeightSample SampleLog::at(uint16_t index) const {
+    uint16_t oldest = (head + SAMPLE_LOG_CAPACITY - count) % SAMPLE_LOG_CAPACITY;
+    return samples[(oldest + index) % SAMPLE_LOG_CAPACITY];
+}
+
+uint32_t SampleLog::beginRead() const {
+    uint32_t token = sequence.load(std::memory_order_acquire);
+    return token;
+}
+
+bool SampleLog::endRead(uint32_t token) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Валидно само ако не е имало запис по време на четенето
+    return (token & 1) == 0 && sequence.load(std::memory_order_relaxed) == token;
+}
@@ -0,0 +1,78 @@
+#include "Sampler.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+#include "Trace.h"
+
+Sampler::Sampler(ScaleManager& scale) : scale(scale) {
+    queue = nullptr;
+    taskHandle = nullptr;
+    monitorId = -1;
+}
+
+bool Sampler::begin() {
+    queue = xQueueCreate(SAMPLE_QUEUE_LENGTH, sizeof(WeightReading));
+    if (!queue) {
+        Serial.println("[Sampler] Queue allocation failed");
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(samplingTask, "sampler", SAMPLER_TASK_STACK, this,
+                                SAMPLER_TASK_PRIORITY, &taskHandle, SAMPLER_TASK_CORE) != pdPASS) {
+        Serial.println("[Sampler] Task creation failed");
+        return false;
+    }
+    monitorId = taskMonitor.add("sampler", taskHandle, SAMPLER_TASK_CORE, SAMPLER_TASK_PRIORITY);
+
+    Serial.printf("[Sampler] Every %d ms on core %d\n", SAMPLE_INTERVAL_MS, SAMPLER_TASK_CORE);
+    return true;
+}
+
+bool Sampler::receive(WeightReading& reading, uint32_t waitMs) {
+    if (!queue) {
+        return false;
+    }
+    return xQueueReceive(queue, &reading, pdMS_TO_TICKS(waitMs)) == pdTRUE;
+}
+
+void Sampler::samplingTask(void* context) {
+    static_cast<Sampler*>(context)->runTask();
+}
+
+void Sampler::runTask() {
+    TickType_t wake = xTaskGetTickCount();
+    uint32_t lastSampleMs = 0;
+
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(SAMPLE_INTERVAL_MS));
+        TaskBusy busy(monitorId);
+
+        uint32_t now = millis();
+        if (lastSampleMs != 0) {
+            long interval = now - lastSampleMs;
+            metrics.samplingJitterMs.observe(abs(interval - (long)SAMPLE_INTERVAL_MS));
+        }
+        lastSampleMs = now;
+
+        // NaN - HX711 не е готов или е зает (тариране/калибрация от loop())
+        TRACE_BEGIN("hx711");
+        float weight = scale.getRawWeight();
+        TRACE_END("hx711");
+        if (isnan(weight)) {
+            metrics.scaleSamplesDropped.inc();
+            continue;
+        }
+
+        if (metrics.scaleSamplesRead.get() == 0) {
+            metrics.bootToFirstSampleMs.set(now);
+        }
+        metrics.scaleSamplesRead.inc();
+
+        // loop() е блокиран по-дълго от опашката - губи се най-старата проба
+        WeightReading reading = { now, weight };
+        if (xQueueSend(queue, &reading, 0) != pdTRUE) {
+            WeightReading oldest;
+            xQueueReceive(queue, &oldest, 0);
+            xQueueSend(queue, &reading, 0);
+            metrics.scaleSamplesDropped.inc();
+        }
+    }
+}
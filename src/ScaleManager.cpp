@@ -1,4 +1,6 @@
 #include "ScaleManager.h"
+#include "Metrics.h"
+#include "EventBus.h"
 
 ScaleManager::ScaleManager(uint8_t dataPin, uint8_t clockPin) {
     scale.begin(dataPin, clockPin);
@@ -6,12 +8,29 @@ ScaleManager::ScaleManager(uint8_t dataPin, uint8_t clockPin) {
     tareOffset = 0;
     calibrated = false;
     currentUnit = GRAMS;
+    hx711Mutex = nullptr;
 }
 
 void ScaleManager::begin() {
+    hx711Mutex = xSemaphoreCreateMutex();
     loadConfiguration();
 }
 
+// Преди begin() (без mutex) всичко е в setup()
+bool ScaleManager::lock(uint32_t waitMs) {
+    if (!hx711Mutex) {
+        return true;
+    }
+    TickType_t ticks = waitMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(waitMs);
+    return xSemaphoreTake(hx711Mutex, ticks) == pdTRUE;
+}
+
+void ScaleManager::unlock() {
+    if (hx711Mutex) {
+        xSemaphoreGive(hx711Mutex);
+    }
+}
+
 void ScaleManager::loadConfiguration() {
     prefs.begin("scale", true);
     calibrationFactor = prefs.getFloat("cal_factor", 1.0f);
@@ -35,6 +54,7 @@ void ScaleManager::saveConfiguration() {
     prefs.putBool("calibrated", calibrated);
     prefs.putUChar("unit", currentUnit);
     prefs.end();
+    metrics.nvsWrites.inc(4);
     Serial.println("[Scale] Configuration saved");
 }
 
@@ -44,6 +64,9 @@ bool ScaleManager::performCalibration(float knownWeight) {
         return false;
     }
     
+    // Докато трае калибрацията, пробите се пропускат
+    lock(portMAX_DELAY);
+    
     Serial.println("[Scale] STEP 1: Remove all weight...");
     delay(5000);
     
@@ -88,6 +111,8 @@ bool ScaleManager::performCalibration(float knownWeight) {
     Serial.printf("[Scale] Test: %.1fg (Expected: %.1fg), Error: %.1f%%\n", 
                   testWeight, knownWeight, errorPercent);
     
+    unlock();
+    
     if (errorPercent < 5.0f) {
         calibrated = true;
         saveConfiguration();
@@ -100,20 +125,57 @@ bool ScaleManager::performCalibration(float knownWeight) {
 }
 
 void ScaleManager::performTare() {
+    lock(portMAX_DELAY);
     scale.tare();
+    TareDoneEvent event = { scale.get_offset() };
+    unlock();
     Serial.println("[Scale] Tared");
+    EventBus::publish(event);
 }
 
-float ScaleManager::getRawWeight() {
-    if (!scale.is_ready()) {
+bool ScaleManager::readRawSample(long& raw) {
+    if (!scale.is_ready() || !lock(SCALE_LOCK_WAIT_MS)) {
+        return false;
+    }
+    raw = scale.read();
+    unlock();
+    return true;
+}
+
+void ScaleManager::applyTare(long offset) {
+    lock(portMAX_DELAY);
+    scale.set_offset(offset);
+    unlock();
+    Serial.println("[Scale] Tared");
+    TareDoneEvent event = { offset };
+    EventBus::publish(event);
+}
+
+void ScaleManager::applyCalibration(long offset, float factor) {
+    tareOffset = offset;
+    calibrationFactor = factor;
+    calibrated = true;
+    lock(portMAX_DELAY);
+    scale.set_offset(tareOffset);
+    scale.set_scale(calibrationFactor);
+    unlock();
+    saveConfiguration();
+    Serial.printf("[Scale] Calibration applied: Factor=%.6f, Offset=%ld\n", factor, offset);
+}
+
+float ScaleManager::getRawWeight(uint32_t waitMs) {
+    if (!scale.is_ready() || !lock(waitMs)) {
         return NAN;
     }
     
+    float weight;
     if (calibrated) {
-        return scale.get_units(1);
+        weight = scale.get_units(1);
     } else {
-        return scale.read() - tareOffset;
+        weight = scale.read() - tareOffset;
     }
+    unlock();
+    return weight;
 }
 
 float ScaleManager::getWeight() {
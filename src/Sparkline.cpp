@@ -0,0 +1,151 @@
+#include "Sparkline.h"
+#include <math.h>
+
+Sparkline::Sparkline(Mode mode, uint32_t spanSeconds) {
+    this->mode = mode;
+    if (mode == MODE_WINDOW) {
+        initialSpan = spanSeconds / SPARKLINE_COLUMNS;
+    } else {
+        initialSpan = spanSeconds;
+    }
+    if (initialSpan == 0) {
+        initialSpan = 1;
+    }
+    reset();
+}
+
+void Sparkline::reset(uint32_t start) {
+    columnSpan = initialSpan;
+    origin = start;
+    headBucket = 0;
+    head = 0;
+    empty = true;
+    lastValue = 0.0f;
+    for (uint16_t i = 0; i < SPARKLINE_COLUMNS; i++) {
+        clearColumn(columns[i]);
+    }
+}
+
+void Sparkline::clearColumn(Column& column) {
+    column.minValue = 0.0f;
+    column.maxValue = 0.0f;
+    column.used = false;
+}
+
+void Sparkline::merge(Column& column, float minValue, float maxValue) {
+    if (!column.used) {
+        column.minValue = minValue;
+        column.maxValue = maxValue;
+        column.used = true;
+        return;
+    }
+    if (minValue < column.minValue) column.minValue = minValue;
+    if (maxValue > column.maxValue) column.maxValue = maxValue;
+}
+
+// Двойките колони стават една, интервалът се удвоява
+void Sparkline::compact() {
+    const uint8_t half = SPARKLINE_COLUMNS / 2;
+    for (uint8_t i = 0; i < half; i++) {
+        Column combined = columns[2 * i];
+        const Column& right = columns[2 * i + 1];
+        if (right.used) {
+            merge(combined, right.minValue, right.maxValue);
+        }
+        columns[i] = combined;
+    }
+    for (uint8_t i = half; i < SPARKLINE_COLUMNS; i++) {
+        clearColumn(columns[i]);
+    }
+    columnSpan *= 2;
+    head /= 2;
+}
+
+void Sparkline::add(uint32_t t, float value) {
+    if (isnan(value)) {
+        return;
+    }
+
+    if (mode == MODE_WINDOW) {
+        uint32_t bucket = t / columnSpan;
+        if (empty) {
+            headBucket = bucket;
+        } else if (bucket < headBucket) {
+            return;
+        } else if (bucket > headBucket) {
+            // Изминалите интервали без проби остават празни колони
+            uint32_t advance = bucket - headBucket;
+            if (advance > SPARKLINE_COLUMNS) {
+                advance = SPARKLINE_COLUMNS;
+            }
+            for (uint32_t i = 0; i < advance; i++) {
+                head = (head + 1) % SPARKLINE_COLUMNS;
+                clearColumn(columns[head]);
+            }
+            headBucket = bucket;
+        }
+        merge(columns[head], value, value);
+    } else {
+        if (t < origin) {
+            return;
+        }
+        uint32_t index = (t - origin) / columnSpan;
+        if (!empty && index < head) {
+            return;
+        }
+        while (index >= SPARKLINE_COLUMNS) {
+            compact();
+            index = (t - origin) / columnSpan;
+        }
+        head = index;
+        merge(columns[head], value, value);
+    }
+
+    empty = false;
+    lastValue = value;
+}
+
+bool Sparkline::column(uint8_t index, float& minValue, float& maxValue) const {
+    if (index >= SPARKLINE_COLUMNS) {
+        return false;
+    }
+    // WINDOW: най-новата колона е най-дясната
+    uint8_t slot = index;
+    if (mode == MODE_WINDOW) {
+        slot = (head + 1 + index) % SPARKLINE_COLUMNS;
+    }
+    const Column& c = columns[slot];
+    if (!c.used) {
+        return false;
+    }
+    minValue = c.minValue;
+    maxValue = c.maxValue;
+    return true;
+}
+
+uint8_t Sparkline::usedColumns() const {
+    if (empty) {
+        return 0;
+    }
+    if (mode == MODE_WINDOW) {
+        return SPARKLINE_COLUMNS;
+    }
+    return head + 1;
+}
+
+bool Sparkline::range(float& minValue, float& maxValue) const {
+    if (empty) {
+        return false;
+    }
+    bool found = false;
+    for (uint16_t i = 0; i < SPARKLINE_COLUMNS; i++) {
+        const Column& c = columns[i];
+        if (!c.used) {
+            continue;
+        }
+        if (!found || c.minValue < minValue) minValue = c.minValue;
+        if (!found || c.maxValue > maxValue) maxValue = c.maxValue;
+        found = true;
+    }
+    return found;
+}
@@ -1,6 +1,16 @@
 #include "StorageManager.h"
+#include "Metrics.h"
+#include "TaskMonitor.h"
+#include "Trace.h"
+
+// Заявките от loop() към задачата за запис
+static portMUX_TYPE flushMux = portMUX_INITIALIZER_UNLOCKED;
 
 StorageManager::StorageManager() {
+    pendingOps = 0;
+    taskHandle = nullptr;
+    monitorId = -1;
+    formatCount.store(0, std::memory_order_relaxed);
 }
 
 bool StorageManager::begin() {
@@ -15,17 +25,105 @@ bool StorageManager::begin() {
 }
 
 void StorageManager::format() {
+    if (!taskHandle) {
+        formatNow();
+        return;
+    }
+    requestOps(FLUSH_FORMAT, FLUSH_SAVE | FLUSH_ARCHIVE | FLUSH_CLEAR);
+}
+
+void StorageManager::formatNow() {
     Serial.println("[Storage] Formatting LittleFS...");
     LittleFS.format();
+    formatCount.fetch_add(1, std::memory_order_release);
     Serial.println("[Storage] Format complete");
 }
 
+void StorageManager::requestOps(uint8_t ops, uint8_t cancels) {
+    portENTER_CRITICAL(&flushMux);
+    pendingOps = (pendingOps & ~cancels) | ops;
+    portEXIT_CRITICAL(&flushMux);
+    xTaskNotifyGive(taskHandle);
+}
+
+bool StorageManager::startFlushTask() {
+    if (xTaskCreatePinnedToCore(flushTask, "storage", STORAGE_TASK_STACK, this,
+                                STORAGE_TASK_PRIORITY, &taskHandle, STORAGE_TASK_CORE) != pdPASS) {
+        taskHandle = nullptr;
+        Serial.println("[Storage] Flush task failed, writing synchronously");
+        return false;
+    }
+    monitorId = taskMonitor.add("storage", taskHandle, STORAGE_TASK_CORE, STORAGE_TASK_PRIORITY);
+    return true;
+}
+
+void StorageManager::flushTask(void* context) {
+    static_cast<StorageManager*>(context)->runTask();
+}
+
+// Няколко заявки преди събуждането се сливат - записва се последната сесия
+void StorageManager::runTask() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TaskBusy busy(monitorId);
+        
+        portENTER_CRITICAL(&flushMux);
+        uint8_t ops = pendingOps & (FLUSH_FORMAT | FLUSH_CLEAR);
+        pendingOps &= ~ops;
+        portEXIT_CRITICAL(&flushMux);
+        if (ops & FLUSH_FORMAT) {
+            formatNow();
+        } else if (ops & FLUSH_CLEAR) {
+            clearNow();
+        }
+        
+        portENTER_CRITICAL(&flushMux);
+        ops = pendingOps & FLUSH_SAVE;
+        if (ops) {
+            memcpy(&flushCopy, &pendingSave, sizeof(flushCopy));
+            pendingOps &= ~FLUSH_SAVE;
+        }
+        portEXIT_CRITICAL(&flushMux);
+        if (ops) {
+            writeSession(flushCopy);
+        }
+        
+        portENTER_CRITICAL(&flushMux);
+        ops = pendingOps & FLUSH_ARCHIVE;
+        if (ops) {
+            memcpy(&flushCopy, &pendingArchive, sizeof(flushCopy));
+            pendingOps &= ~FLUSH_ARCHIVE;
+        }
+        portEXIT_CRITICAL(&flushMux);
+        if (ops) {
+            writeArchive(flushCopy);
+        }
+    }
+}
+
 bool StorageManager::saveSession(const DryingSession& session) {
-    if (!saveSessionInfo(session)) {
+    if (!taskHandle) {
+        return writeSession(session);
+    }
+    portENTER_CRITICAL(&flushMux);
+    memcpy(&pendingSave, &session, sizeof(pendingSave));
+    pendingOps = (pendingOps & ~FLUSH_CLEAR) | FLUSH_SAVE;  // Записът презаписва файловете
+    portEXIT_CRITICAL(&flushMux);
+    xTaskNotifyGive(taskHandle);
+    return true;
+}
+
+bool StorageManager::writeSession(const DryingSession& session) {
+    return writeSession(session, SESSION_FILE, RECORDS_FILE);
+}
+
+bool StorageManager::writeSession(const DryingSession& session, const char* sessionFile, const char* recordsFile) {
+    TRACE_SCOPE("fs_session");
+    if (!saveSessionInfo(session, sessionFile)) {
         return false;
     }
     
-    if (!saveRecords(session)) {
+    if (!saveRecords(session, recordsFile)) {
         return false;
     }
     
@@ -33,7 +131,7 @@ bool StorageManager::saveSession(const DryingSession& session) {
     return true;
 }
 
-bool StorageManager::saveSessionInfo(const DryingSession& session) {
+bool StorageManager::saveSessionInfo(const DryingSession& session, const char* path) {
     StaticJsonDocument<256> doc;
     
     doc["active"] = session.isActive;
@@ -44,14 +142,16 @@ bool StorageManager::saveSessionInfo(const DryingSession& session) {
     doc["recordCount"] = session.recordCount;
     doc["lastRecordTime"] = session.lastRecordTimestamp;  // Запази
     
-    File file = LittleFS.open(SESSION_FILE, "w");
+    File file = LittleFS.open(path, "w");
     if (!file) {
-        Serial.println("[Storage] Failed to open session.json for writing");
+        Serial.printf("[Storage] Failed to open %s for writing\n", path);
         return false;
     }
     
-    if (serializeJson(doc, file) == 0) {
-        Serial.println("[Storage] Failed to write session.json");
+    size_t written = serializeJson(doc, file);
+    metrics.fsBytesWritten.inc(written);
+    if (written == 0) {
+        Serial.printf("[Storage] Failed to write %s\n", path);
         file.close();
         return false;
     }
@@ -61,7 +161,7 @@ bool StorageManager::saveSessionInfo(const DryingSession& session) {
     return true;
 }
 
-bool StorageManager::saveRecords(const DryingSession& session) {
+bool StorageManager::saveRecords(const DryingSession& session, const char* path) {
     DynamicJsonDocument doc(4096); // До 60 записа
     JsonArray recordsArray = doc.createNestedArray("records");
     
@@ -74,14 +174,16 @@ bool StorageManager::saveRecords(const DryingSession& session) {
         record["change"] = session.records[i].dayChange;
     }
     
-    File file = LittleFS.open(RECORDS_FILE, "w");
+    File file = LittleFS.open(path, "w");
     if (!file) {
-        Serial.println("[Storage] Failed to open records.json for writing");
+        Serial.printf("[Storage] Failed to open %s for writing\n", path);
         return false;
     }
     
-    if (serializeJson(doc, file) == 0) {
-        Serial.println("[Storage] Failed to write records.json");
+    size_t written = serializeJson(doc, file);
+    metrics.fsBytesWritten.inc(written);
+    if (written == 0) {
+        Serial.printf("[Storage] Failed to write %s\n", path);
         file.close();
         return false;
     }
@@ -92,8 +194,12 @@ bool StorageManager::saveRecords(const DryingSession& session) {
 }
 
 bool StorageManager::loadSession(DryingSession& session) {
+    return loadSession(session, SESSION_FILE, RECORDS_FILE);
+}
+
+bool StorageManager::loadSession(DryingSession& session, const char* sessionFile, const char* recordsFile) {
     // Зареждане на session info
-    File file = LittleFS.open(SESSION_FILE, "r");
+    File file = LittleFS.open(sessionFile, "r");
     if (!file) {
         Serial.println("[Storage] No session file found");
         session.isActive = false;
@@ -105,7 +211,7 @@ bool StorageManager::loadSession(DryingSession& session) {
     file.close();
     
     if (error) {
-        Serial.printf("[Storage] Failed to parse session.json: %s\n", error.c_str());
+        Serial.printf("[Storage] Failed to parse %s: %s\n", sessionFile, error.c_str());
         return false;
     }
     
@@ -120,15 +226,15 @@ bool StorageManager::loadSession(DryingSession& session) {
     Serial.println("[Storage] Session info loaded");
     
     // Зареждане на records
-    if (!loadRecords(session)) {
+    if (!loadRecords(session, recordsFile)) {
         session.recordCount = 0;
     }
     
     return true;
 }
 
-bool StorageManager::loadRecords(DryingSession& session) {
-    File file = LittleFS.open(RECORDS_FILE, "r");
+bool StorageManager::loadRecords(DryingSession& session, const char* path) {
+    File file = LittleFS.open(path, "r");
     if (!file) {
         Serial.println("[Storage] No records file found");
         return false;
@@ -139,7 +245,7 @@ bool StorageManager::loadRecords(DryingSession& session) {
     file.close();
     
     if (error) {
-        Serial.printf("[Storage] Failed to parse records.json: %s\n", error.c_str());
+        Serial.printf("[Storage] Failed to parse %s: %s\n", path, error.c_str());
         return false;
     }
     
@@ -163,58 +269,180 @@ bool StorageManager::loadRecords(DryingSession& session) {
 }
 
 void StorageManager::clearSession() {
-    LittleFS.remove(SESSION_FILE);
-    LittleFS.remove(RECORDS_FILE);
+    if (!taskHandle) {
+        clearNow();
+        return;
+    }
+    requestOps(FLUSH_CLEAR, FLUSH_SAVE);
+}
+
+void StorageManager::clearNow() {
+    removeSession(SESSION_FILE, RECORDS_FILE);
     Serial.println("[Storage] Session cleared");
 }
 
-bool StorageManager::addDailyRecord(DryingSession& session, float weight) {
-    if (session.recordCount >= MAX_DAILY_RECORDS) {
-        Serial.println("[Storage] Max records reached!");
+void StorageManager::removeSession(const char* sessionFile, const char* recordsFile) {
+    LittleFS.remove(sessionFile);
+    LittleFS.remove(recordsFile);
+}
+
+void StorageManager::archivePath(uint16_t id, char* path, size_t size) {
+    snprintf(path, size, "%s/%u.bin", ARCHIVE_DIR, id);
+}
+
+bool StorageManager::archiveSession(const DryingSession& session) {
+    if (session.recordCount == 0) {
+        return false;
+    }
+    if (!taskHandle) {
+        return writeArchive(session);
+    }
+    portENTER_CRITICAL(&flushMux);
+    memcpy(&pendingArchive, &session, sizeof(pendingArchive));
+    pendingOps |= FLUSH_ARCHIVE;
+    portEXIT_CRITICAL(&flushMux);
+    xTaskNotifyGive(taskHandle);
+    return true;
+}
+
+bool StorageManager::writeArchive(const DryingSession& session) {    
+    TRACE_SCOPE("fs_archive");
+    if (!LittleFS.exists(ARCHIVE_DIR)) {
+        LittleFS.mkdir(ARCHIVE_DIR);
+    }
+    
+    // Следващ id = най-големия + 1; най-старите над лимита се трият
+    SessionArchiveInfo archives[MAX_ARCHIVES + 1];
+    uint8_t count = listArchives(archives, MAX_ARCHIVES + 1);
+    uint16_t nextId = 1;
+    for (uint8_t i = 0; i < count; i++) {
+        if (archives[i].id >= nextId) nextId = archives[i].id + 1;
+    }
+    
+    char path[32];
+    for (uint8_t i = 0; count - i >= MAX_ARCHIVES; i++) {
+        // listArchives връща подредени по id (най-старите първи)
+        archivePath(archives[i].id, path, sizeof(path));
+        LittleFS.remove(path);
+        Serial.printf("[Storage] Old archive %u removed\n", archives[i].id);
+    }
+    
+    ArchiveHeader header;
+    header.magic = ARCHIVE_MAGIC;
+    header.startTimestamp = session.startTimestamp;
+    header.initialWeight = session.initialWeight;
+    header.targetLossPercent = session.targetLossPercent;
+    header.recordCount = session.recordCount;
+    header.currentDay = session.currentDay;
+    header.lastRecordTimestamp = session.lastRecordTimestamp;
+    
+    archivePath(nextId, path, sizeof(path));
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        Serial.printf("[Storage] Failed to open %s for writing\n", path);
         return false;
     }
     
-    // Изчисляване на % загуба
-    float totalLoss = session.initialWeight - weight;
-    float lossPercent = (totalLoss / session.initialWeight) * 100.0f;
+    size_t recordsSize = sizeof(DailyRecord) * session.recordCount;
+    size_t headerWritten = file.write((const uint8_t*)&header, sizeof(header));
+    size_t recordsWritten = headerWritten == sizeof(header) ?
+                            file.write((const uint8_t*)session.records, recordsSize) : 0;
+    bool ok = headerWritten == sizeof(header) && recordsWritten == recordsSize;
+    file.close();
+    metrics.fsBytesWritten.inc(headerWritten + recordsWritten);
     
-    // Изчисляване на промяна от предишния ден
-    float dayChange = 0.0f;
-    if (session.recordCount > 0) {
-        dayChange = session.records[session.recordCount - 1].weight - weight;
+    if (!ok) {
+        Serial.printf("[Storage] Failed to write %s\n", path);
+        LittleFS.remove(path);
+        return false;
+    }
+    
+    Serial.printf("[Storage] Session archived as #%u (%d records)\n", nextId, session.recordCount);
+    return true;
+}
+
+uint8_t StorageManager::listArchives(SessionArchiveInfo* out, uint8_t maxCount) {
+    File dir = LittleFS.open(ARCHIVE_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return 0;
     }
     
-    // Добавяне на нов запис
-    DailyRecord& record = session.records[session.recordCount];
-    record.day = session.currentDay;
-    record.timestamp = millis() / 1000; // Unix time (simplified)
-    record.weight = weight;
-    record.lossPercent = lossPercent;
-    record.dayChange = dayChange;
+    uint8_t count = 0;
+    File file = dir.openNextFile();
+    while (file && count < maxCount) {
+        uint16_t id = (uint16_t)atoi(file.name());
+        ArchiveHeader header;
+        
+        if (id > 0 && file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == ARCHIVE_MAGIC) {
+            // Вмъкване по id - файловете не са подредени
+            uint8_t pos = count;
+            while (pos > 0 && out[pos - 1].id > id) {
+                out[pos] = out[pos - 1];
+                pos--;
+            }
+            out[pos].id = id;
+            out[pos].startTimestamp = header.startTimestamp;
+            out[pos].initialWeight = header.initialWeight;
+            out[pos].targetLossPercent = header.targetLossPercent;
+            out[pos].recordCount = header.recordCount;
+            count++;
+        }
+        
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
     
-    session.recordCount++;
-    session.currentDay++;
+    return count;
+}
 
-    session.lastRecordTimestamp = record.timestamp; 
+bool StorageManager::loadArchive(uint16_t id, DryingSession& session) {
+    char path[32];
+    archivePath(id, path, sizeof(path));
+    
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return false;
+    }
     
-    Serial.printf("[Storage] Day %d recorded: %.1fg, Loss: %.1f%%, Change: %.1fg\n",
-                  record.day, record.weight, record.lossPercent, record.dayChange);
+    ArchiveHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != ARCHIVE_MAGIC || header.recordCount > MAX_DAILY_RECORDS) {
+        file.close();
+        Serial.printf("[Storage] Archive #%u is corrupt\n", id);
+        return false;
+    }
+    
+    size_t recordsSize = sizeof(DailyRecord) * header.recordCount;
+    bool ok = file.read((uint8_t*)session.records, recordsSize) == recordsSize;
+    file.close();
     
-    // Автоматично запазване
-    return saveSession(session);
+    if (!ok) {
+        return false;
+    }
+    
+    session.isActive = false;
+    session.initialWeight = header.initialWeight;
+    session.targetLossPercent = header.targetLossPercent;
+    session.startTimestamp = header.startTimestamp;
+    session.currentDay = header.currentDay;
+    session.lastRecordTimestamp = header.lastRecordTimestamp;
+    session.recordCount = header.recordCount;
+    return true;
 }
 
 void StorageManager::printFileSystem() {
     Serial.println("[Storage] === File System Info ===");
-    Serial.printf("Total: %d bytes\n", getTotalSpace());
-    Serial.printf("Used: %d bytes\n", getUsedSpace());
+    Serial.printf("Total: %u bytes\n", (unsigned)getTotalSpace());
+    Serial.printf("Used: %u bytes\n", (unsigned)getUsedSpace());
     Serial.println("[Storage] === Files ===");
     
     File root = LittleFS.open("/");
     File file = root.openNextFile();
     
     while (file) {
-        Serial.printf("  %s (%d bytes)\n", file.name(), file.size());
+        Serial.printf("  %s (%u bytes)\n", file.name(), (unsigned)file.size());
         file = root.openNextFile();
     }
     
@@ -0,0 +1,67 @@
+#include "SystemState.h"
+#include <string.h>
+
+SystemState::SystemState() : sequence(0) {
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.daysRemaining = -1;
+}
+
+void SystemState::publish(const SystemSnapshot& next) {
+    // Нечетно - читателите ще повторят
+    sequence.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    snapshot = next;
+
+    sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool SystemState::read(SystemSnapshot& out) const {
+    for (uint8_t attempt = 0; attempt < READ_RETRIES; attempt++) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+
+        out = snapshot;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============= Стабилност =============
+
+StabilityTracker::StabilityTracker() {
+    reset();
+}
+
+void StabilityTracker::add(float weight) {
+    window[head] = weight;
+    head = (head + 1) % STABILITY_WINDOW;
+    if (count < STABILITY_WINDOW) {
+        count++;
+    }
+}
+
+void StabilityTracker::reset() {
+    head = 0;
+    count = 0;
+}
+
+bool StabilityTracker::isStable() const {
+    if (count < STABILITY_WINDOW) {
+        return false;
+    }
+
+    float low = window[0];
+    float high = window[0];
+    for (uint8_t i = 1; i < count; i++) {
+        if (window[i] < low) low = window[i];
+        if (window[i] > high) high = window[i];
+    }
+    return high - low <= STABILITY_RANGE;
+}
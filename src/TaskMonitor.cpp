@@ -0,0 +1,84 @@
+#include "TaskMonitor.h"
+
+TaskMonitor taskMonitor;
+
+TaskMonitor::TaskMonitor() : count(0) {
+    lastPrint = 0;
+}
+
+// Вика се от begin() на модулите, след xTaskCreatePinnedToCore
+int8_t TaskMonitor::add(const char* name, TaskHandle_t handle, uint8_t core, uint8_t priority) {
+    uint8_t id = count.load();
+    if (id >= METRICS_MAX_TASKS) {
+        Serial.printf("[Tasks] No slot for %s\n", name);
+        return -1;
+    }
+
+    Entry& entry = entries[id];
+    entry.name = name;
+    entry.handle = handle;
+    entry.core = core;
+    entry.priority = priority;
+    entry.pendingUs = 0;
+    entry.busyMs.store(0);
+    entry.printedMs = 0;
+
+    // Записът е попълнен преди да стане видим за snapshot()
+    count.store(id + 1);
+    return id;
+}
+
+void TaskMonitor::addBusy(int8_t id, uint32_t us) {
+    if (id < 0 || id >= (int8_t)count.load()) {
+        return;
+    }
+    Entry& entry = entries[id];
+    entry.pendingUs += us;
+    if (entry.pendingUs >= 1000) {
+        entry.busyMs.fetch_add(entry.pendingUs / 1000, std::memory_order_relaxed);
+        entry.pendingUs %= 1000;
+    }
+}
+
+uint8_t TaskMonitor::snapshot(MetricsTask* out, uint8_t maxCount) {
+    uint8_t n = count.load();
+    if (n > maxCount) n = maxCount;
+
+    for (uint8_t i = 0; i < n; i++) {
+        const Entry& entry = entries[i];
+        out[i].name = entry.name;
+        out[i].core = entry.core;
+        out[i].priority = entry.priority;
+        // В ESP-IDF стекът е в байтове, не в думи
+        out[i].stackFreeBytes = entry.handle ? uxTaskGetStackHighWaterMark(entry.handle) : 0;
+        out[i].cpuMs = entry.busyMs.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+void TaskMonitor::print() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - lastPrint;
+    uint8_t n = count.load();
+
+    Serial.println("Task        core prio  stack free   cpu ms   busy");
+    for (uint8_t i = 0; i < n; i++) {
+        Entry& entry = entries[i];
+        uint32_t busy = entry.busyMs.load(std::memory_order_relaxed);
+        float percent = elapsed > 0 ? (busy - entry.printedMs) * 100.0f / elapsed : 0.0f;
+        uint32_t stackFree = entry.handle ? uxTaskGetStackHighWaterMark(entry.handle) : 0;
+
+        Serial.printf("%-11s %4u %4u %10lu %8lu %5.1f%%\n", entry.name, entry.core, entry.priority,
+                      (unsigned long)stackFree, (unsigned long)busy, percent);
+        entry.printedMs = busy;
+    }
+    lastPrint = now;
+}
+
+TaskBusy::TaskBusy(int8_t id) : id(id) {
+    start = micros();
+}
+
+TaskBusy::~TaskBusy() {
+    taskMonitor.addBusy(id, micros() - start);
+}
@@ -0,0 +1,133 @@
+#include "Trace.h"
+
+TraceBuffer traceBuffer;
+
+// Print в буфер на извикващия; при препълване спира и го отбелязва
+class TraceBufferPrint : public Print {
+public:
+    TraceBufferPrint(char* buffer, size_t size) : buffer(buffer), size(size), length(0), overflow(false) {
+        buffer[0] = '\0';
+    }
+
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t count) override {
+        if (overflow || length + count >= size) {
+            overflow = true;
+            return 0;
+        }
+        memcpy(buffer + length, data, count);
+        length += count;
+        buffer[length] = '\0';
+        return count;
+    }
+
+    size_t getLength() const { return length; }
+    bool overflowed() const { return overflow; }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+};
+
+TraceBuffer::TraceBuffer() : head(0), readers(0) {
+    for (uint16_t i = 0; i < TRACE_CAPACITY; i++) {
+        events[i].name = nullptr;
+        events[i].sequence.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+}
+
+void TraceBuffer::clear() {
+    readers.fetch_add(1);
+    for (uint16_t i = 0; i < TRACE_CAPACITY; i++) {
+        events[i].sequence.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+    head.store(0);
+    readers.fetch_sub(1);
+}
+
+void TraceBuffer::printJson(Print& out, uint16_t maxEvents) {
+    readers.fetch_add(1);
+
+    uint32_t end = head.load();
+    uint32_t count = end < TRACE_CAPACITY ? end : TRACE_CAPACITY;
+    if (count > maxEvents) {
+        count = maxEvents;
+    }
+
+    // Време в µs от tick-а; в рамките на ядрото - от брояча на цикли, докато
+    // паузата между събитията е под половин оборот на 32-битовия брояч
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    uint32_t anchorLimitMs = 0x80000000UL / (mhz * 1000UL);
+    struct CoreClock {
+        bool valid;
+        uint32_t cycles;
+        uint32_t tick;
+        double us;
+    } clocks[2] = {};
+
+    TaskHandle_t tasks[TRACE_MAX_TASKS];
+    uint8_t taskCores[TRACE_MAX_TASKS];
+    uint8_t taskCount = 0;
+
+    char line[128];
+    out.print("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+
+    for (uint32_t sequence = end - count; sequence != end; sequence++) {
+        const TraceEvent& event = events[sequence & (TRACE_CAPACITY - 1)];
+        if (event.sequence.load(std::memory_order_acquire) != sequence || !event.name) {
+            continue;
+        }
+
+        CoreClock& clock = clocks[event.core & 1];
+        if (!clock.valid || (int32_t)(event.tick - clock.tick) > (int32_t)anchorLimitMs) {
+            clock.us = event.tick * 1000.0;
+        } else {
+            clock.us += (int32_t)(event.cycles - clock.cycles) / (double)mhz;
+        }
+        clock.valid = true;
+        clock.cycles = event.cycles;
+        clock.tick = event.tick;
+
+        uint8_t tid = 0;
+        while (tid < taskCount && tasks[tid] != event.task) tid++;
+        if (tid == taskCount && taskCount < TRACE_MAX_TASKS) {
+            tasks[taskCount] = event.task;
+            taskCores[taskCount] = event.core;
+            taskCount++;
+        }
+
+        snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                 first ? "" : ",\n", event.name, event.phase, clock.us, (unsigned)tid);
+        out.print(line);
+        first = false;
+    }
+
+    // Имената на редовете в trace viewer-а
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const char* name = tasks[i] ? pcTaskGetName(tasks[i]) : "main";
+        snprintf(line, sizeof(line),
+                 "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s (core %u)\"}}",
+                 first ? "" : ",\n", (unsigned)i, name, (unsigned)taskCores[i]);
+        out.print(line);
+        first = false;
+    }
+    out.print("\n]}\n");
+
+    readers.fetch_sub(1);
+}
+
+size_t TraceBuffer::writeJson(char* buffer, size_t size) {
+    if (size < TRACE_JSON_OVERHEAD + TRACE_EVENT_JSON_SIZE) {
+        return 0;
+    }
+    size_t fit = (size - TRACE_JSON_OVERHEAD) / TRACE_EVENT_JSON_SIZE;
+    TraceBufferPrint out(buffer, size);
+    printJson(out, fit < TRACE_CAPACITY ? fit : TRACE_CAPACITY);
+    return out.overflowed() ? 0 : out.getLength();
+}
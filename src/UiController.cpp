@@ -0,0 +1,155 @@
+#include "UiController.h"
+
+UiController::UiController(DisplayManager& display, ButtonHandler& buttons,
+                           DryingSessionManager& drying, ScaleManager& scale)
+    : display(display), buttons(buttons), drying(drying), scale(scale),
+      dayGraph(Sparkline::MODE_WINDOW, 24UL * 3600),
+      lossGraph(Sparkline::MODE_SESSION, 60) {
+    lastDisplayUpdate = 0;
+    messageDisplayTime = 0;
+    lastDisplayedWeight = 0.0f;
+    showingMessage = false;
+    lossGraphSession = 0;
+    lossGraphOffset = 0;
+}
+
+void UiController::showMessage(const char* title, const char* message) {
+    display.showMessage(title, message, 0);
+    showingMessage = true;
+    messageDisplayTime = millis();
+}
+
+// Заявки от ButtonHandler (съобщение на екрана / прерисуване)
+void UiController::applyRequests(uint8_t requests) {
+    if (requests & ButtonHandler::UI_MESSAGE_SHOWN) {
+        showingMessage = true;
+        messageDisplayTime = millis();
+    }
+    if (requests & ButtonHandler::UI_REDRAW) {
+        forceRedraw();
+    }
+}
+
+void UiController::forceRedraw() {
+    lastDisplayUpdate = 0;
+    lastDisplayedWeight = -999.0f;
+}
+
+// Графиките за екрана - по една проба, O(1). При нова (или възстановена
+// след рестарт) сесия кривата на загубата се пълни от дневните записи.
+void UiController::addSample(uint32_t timestamp, float weight) {
+    dayGraph.add(timestamp, weight);
+
+    if (!drying.isActive()) {
+        lossGraphSession = 0;
+        return;
+    }
+    DryingSession& session = drying.getSession();
+    if (session.initialWeight <= 0) {
+        return;
+    }
+    if (lossGraphSession != session.startTimestamp || lossGraph.isEmpty()) {
+        lossGraphSession = session.startTimestamp;
+        lossGraph.reset(session.startTimestamp);
+        lossGraphOffset = 0;
+        for (uint8_t i = 0; i < session.recordCount; i++) {
+            lossGraph.add(session.records[i].timestamp, session.records[i].lossPercent);
+        }
+        uint32_t lastRecord = session.lastRecordTimestamp;
+        if (session.recordCount > 0 && session.records[session.recordCount - 1].timestamp > lastRecord) {
+            lastRecord = session.records[session.recordCount - 1].timestamp;
+        }
+        if (timestamp < lastRecord) {
+            lossGraphOffset = lastRecord - timestamp;
+        }
+    }
+    lossGraph.add(timestamp + lossGraphOffset, (session.initialWeight - weight) / session.initialWeight * 100.0f);
+}
+
+void UiController::update(float currentWeight, bool displayBusy) {
+    unsigned long currentTime = millis();
+
+    // ========== MESSAGE TIMEOUT ==========
+    if (showingMessage && (currentTime - messageDisplayTime >= MESSAGE_DISPLAY_DURATION)) {
+        showingMessage = false;
+        lastDisplayUpdate = 0; // Форсирай обновяване
+        lastDisplayedWeight = 0.0f; // Форсирай показване на тегло
+    }
+
+    recordIfDue(currentWeight);
+
+    if (!showingMessage && !displayBusy && currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
+        refreshScreen(currentWeight);
+        lastDisplayUpdate = currentTime;
+    }
+}
+
+// ========== AUTO DAILY RECORD (DRYING MODE) ==========
+void UiController::recordIfDue(float currentWeight) {
+    if (buttons.getMode() != ButtonHandler::OP_MODE_DRYING || !drying.isActive()) {
+        return;
+    }
+
+    DryingSession& session = drying.getSession();
+    uint32_t currentTimestamp = DryingSessionManager::uptimeSeconds();
+    uint32_t elapsed = currentTimestamp - session.lastRecordTimestamp;
+
+    // Ако са минали 24 часа (86400 секунди)
+    if (elapsed < DAILY_RECORD_INTERVAL) {
+        return;
+    }
+    drying.recordDailyWeight(currentWeight);
+    DailyRecord* lastRecord = drying.getLastRecord();
+
+    if (lastRecord) {
+        char title[16];
+        char message[24];
+        TextBuilder(title, sizeof(title)).add("Day ").add((int32_t)lastRecord->day);
+        TextBuilder(message, sizeof(message)).add("Loss: ").add(lastRecord->lossPercent, 1).add("%");
+        showMessage(title, message);
+        Serial.printf("[Auto] Day %d recorded: %.1fg, Loss: %.1f%%\n",
+                     lastRecord->day, lastRecord->weight, lastRecord->lossPercent);
+    }
+}
+
+// ========== DISPLAY UPDATE ==========
+void UiController::refreshScreen(float currentWeight) {
+    if (buttons.getMode() == ButtonHandler::OP_MODE_NORMAL) {
+        if (!isnan(currentWeight)) {
+            if (abs(currentWeight - lastDisplayedWeight) >= DISPLAY_UPDATE_THRESHOLD) {
+                // Превръщането в единицата е в DisplayManager
+                display.showNormalWeight(currentWeight, scale.getUnit());
+                lastDisplayedWeight = currentWeight;
+            }
+        }
+        return;
+    }
+
+    // Провери дали е форсирано обновяване (lastDisplayUpdate == 0)
+    bool forceUpdate = (lastDisplayUpdate == 0);
+
+    switch (display.getMode()) {
+        case DisplayManager::MODE_DRYING_LIVE:
+            // Обнови ако има промяна ИЛИ е форсирано
+            if (forceUpdate || abs(currentWeight - lastDisplayedWeight) >= DISPLAY_UPDATE_THRESHOLD) {
+                display.showDryingLive(drying, currentWeight);
+                lastDisplayedWeight = currentWeight;
+            }
+            break;
+
+        case DisplayManager::MODE_DRYING_STATS:
+            display.showDryingStats(drying);
+            break;
+
+        case DisplayManager::MODE_DRYING_HISTORY:
+            display.showDryingHistory(drying, buttons.getHistoryIndex());
+            break;
+
+        case DisplayManager::MODE_DRYING_GRAPH:
+            display.showDryingGraph(drying, dayGraph, lossGraph);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,257 @@
+#include "WebApi.h"
+#include <string.h>
+
+bool sameStatus(const StatusSnapshot& a, const StatusSnapshot& b) {
+    return a.active == b.active &&
+           a.initialWeight == b.initialWeight &&
+           a.currentWeight == b.currentWeight &&
+           a.targetLoss == b.targetLoss &&
+           a.currentDay == b.currentDay &&
+           a.recordCount == b.recordCount &&
+           a.daysRemaining == b.daysRemaining &&
+           a.isReady == b.isReady;
+}
+
+float realtimeLossPercent(float initialWeight, float currentWeight) {
+    if (initialWeight <= 0) {
+        return 0.0f;
+    }
+    return (initialWeight - currentWeight) / initialWeight * 100.0f;
+}
+
+void writeStatusJson(JsonWriter& json, const StatusSnapshot& snap) {
+    json.beginObject();
+    json.field("active", snap.active);
+    
+    if (snap.active) {
+        json.field("initialWeight", snap.initialWeight, 1);
+        json.field("currentWeight", snap.currentWeight, 1);
+        json.field("targetLoss", snap.targetLoss, 1);
+        json.field("currentLoss", realtimeLossPercent(snap.initialWeight, snap.currentWeight), 1);
+        json.field("currentDay", (int32_t)snap.currentDay);
+        json.field("recordCount", (int32_t)snap.recordCount);
+        json.field("daysRemaining", (int32_t)snap.daysRemaining);
+        json.field("isReady", snap.isReady);
+    } else {
+        json.field("initialWeight", (int32_t)0);
+        json.field("currentWeight", (int32_t)0);
+        json.field("targetLoss", (int32_t)0);
+        json.field("currentLoss", (int32_t)0);
+        json.field("currentDay", (int32_t)0);
+        json.field("recordCount", (int32_t)0);
+        json.field("daysRemaining", (int32_t)0);
+        json.field("isReady", false);
+    }
+    
+    json.endObject();
+}
+
+bool sameHistoryQuery(const HistoryQuery& a, const HistoryQuery& b) {
+    return a.since == b.since &&
+           a.hasSinceTs == b.hasSinceTs && (!a.hasSinceTs || a.sinceTs == b.sinceTs) &&
+           a.hasFrom == b.hasFrom && (!a.hasFrom || a.from == b.from) &&
+           a.hasTo == b.hasTo && (!a.hasTo || a.to == b.to) &&
+           a.limit == b.limit &&
+           a.fields == b.fields;
+}
+
+bool timestampsSorted(const DailyRecord* records, uint8_t count) {
+    for (uint8_t i = 1; i < count; i++) {
+        if (records[i].timestamp < records[i - 1].timestamp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t parseHistoryFields(const char* list) {
+    static const struct { const char* name; uint8_t bit; } NAMES[] = {
+        { "day", FIELD_DAY },
+        { "ts", FIELD_TS },
+        { "weight", FIELD_WEIGHT },
+        { "loss", FIELD_LOSS },
+        { "change", FIELD_CHANGE },
+    };
+    
+    uint8_t mask = 0;
+    const char* p = list;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        
+        bool known = false;
+        for (const auto& field : NAMES) {
+            if (strlen(field.name) == len && strncmp(field.name, p, len) == 0) {
+                mask |= field.bit;
+                known = true;
+                break;
+            }
+        }
+        if (!known && len > 0) {
+            return 0;
+        }
+        
+        p += len;
+        if (*p == ',') p++;
+    }
+    return mask;
+}
+
+// Първият индекс с timestamp > ts (strict) или >= ts
+static uint8_t findTimestamp(const DailyRecord* records, uint8_t count, bool sorted,
+                             uint32_t ts, bool strict) {
+    if (!sorted) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (strict ? records[i].timestamp > ts : records[i].timestamp >= ts) {
+                return i;
+            }
+        }
+        return count;
+    }
+    
+    uint8_t lo = 0;
+    uint8_t hi = count;
+    while (lo < hi) {
+        uint8_t mid = lo + (hi - lo) / 2;
+        bool before = strict ? records[mid].timestamp <= ts : records[mid].timestamp < ts;
+        if (before) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void resolveHistoryRange(const DailyRecord* records, uint8_t count, bool sorted,
+                         const HistoryQuery& query, uint8_t& first, uint8_t& last) {
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    
+    if (query.since > 0) {
+        lo = (uint32_t)query.since;
+    }
+    if (query.hasSinceTs) {
+        uint32_t i = findTimestamp(records, count, sorted, query.sinceTs, true);
+        if (i > lo) lo = i;
+    }
+    if (query.hasFrom) {
+        uint32_t i = findTimestamp(records, count, sorted, query.from, false);
+        if (i > lo) lo = i;
+    }
+    if (query.hasTo) {
+        uint32_t i = findTimestamp(records, count, sorted, query.to, true);
+        if (i < hi) hi = i;
+    }
+    if (lo > count) lo = count;
+    if (hi < lo) hi = lo;
+    if (query.limit > 0 && hi - lo > query.limit) {
+        hi = lo + query.limit;
+    }
+    
+    first = (uint8_t)lo;
+    last = (uint8_t)hi;
+}
+
+void writeHistoryJson(JsonWriter& json, bool active, uint16_t archiveId, uint32_t sessionStart,
+                      const DailyRecord* records, uint8_t count, bool sorted,
+                      const HistoryQuery& query) {
+    uint8_t first;
+    uint8_t last;
+    resolveHistoryRange(records, count, sorted, query, first, last);
+    
+    json.beginObject();
+    json.field("active", active);
+    json.field("archive", (uint32_t)archiveId);
+    json.field("sessionStart", sessionStart);
+    json.field("total", (int32_t)count);
+    json.field("start", (int32_t)first);
+    json.field("next", (int32_t)last);
+    json.key("records").beginArray();
+    
+    for (uint8_t i = first; i < last; i++) {
+        const DailyRecord& record = records[i];
+        json.beginObject();
+        if (query.fields & FIELD_DAY) json.field("day", (int32_t)record.day);
+        if (query.fields & FIELD_TS) json.field("ts", record.timestamp);
+        if (query.fields & FIELD_WEIGHT) json.field("weight", record.weight, 1);
+        if (query.fields & FIELD_LOSS) json.field("loss", record.lossPercent, 1);
+        if (query.fields & FIELD_CHANGE) json.field("change", record.dayChange, 1);
+        json.endObject();
+    }
+    
+    json.endArray();
+    json.endObject();
+}
+
+void writeSessionListJson(JsonWriter& json, const SessionArchiveInfo* sessions, uint8_t count) {
+    json.beginObject();
+    json.key("sessions").beginArray();
+    
+    for (uint8_t i = 0; i < count; i++) {
+        json.beginObject();
+        json.field("id", (uint32_t)sessions[i].id);
+        json.field("sessionStart", sessions[i].startTimestamp);
+        json.field("initialWeight", sessions[i].initialWeight, 1);
+        json.field("targetLoss", sessions[i].targetLossPercent, 1);
+        json.field("records", (int32_t)sessions[i].recordCount);
+        json.endObject();
+    }
+    
+    json.endArray();
+    json.endObject();
+}
+
+bool parseSeriesMode(const char* name, Downsampler::Mode& mode) {
+    if (strcmp(name, "lttb") == 0) {
+        mode = Downsampler::MODE_LTTB;
+        return true;
+    }
+    if (strcmp(name, "minmax") == 0) {
+        mode = Downsampler::MODE_MINMAX;
+        return true;
+    }
+    return false;
+}
+
+static void emitSeriesPoint(void* context, uint32_t t, float value) {
+    JsonWriter& json = *static_cast<JsonWriter*>(context);
+    json.beginArray();
+    json.value(t);
+    json.value(value, 1);
+    json.endArray();
+}
+
+void writeSeriesJson(JsonWriter& json, const char* source, const SeriesQuery& query,
+                     uint16_t count, SeriesReadFn read, void* context) {
+    uint32_t from = query.from;
+    uint32_t to = query.to;
+    uint32_t t;
+    float value;
+
+    if (count > 0) {
+        if (!query.hasFrom) {
+            read(context, 0, t, value);
+            from = t;
+        }
+        if (!query.hasTo) {
+            read(context, count - 1, t, value);
+            to = t;
+        }
+    }
+
+    json.beginObject();
+    json.field("source", source);
+    json.field("mode", query.mode == Downsampler::MODE_LTTB ? "lttb" : "minmax");
+    json.field("from", from);
+    json.field("to", to);
+    json.key("points").beginArray();
+
+    Downsampler sampler(query.mode, from, to, query.points, emitSeriesPoint, &json);
+    for (uint16_t i = 0; i < count; i++) {
+        read(context, i, t, value);
+        sampler.add(t, value);
+    }
+    sampler.finish();
+
+    json.endArray();
+    json.field("input", sampler.getInputCount());
+    json.endObject();
+}
@@ -1,243 +1,546 @@
 #include "WebServerManager.h"
-#include "WebPages.h"
+#include "WebAssets.h"
+#include "JsonWriter.h"
+#include "TaskMonitor.h"
+#include "Trace.h"
+#include <esp_heap_caps.h>
 
-WebServerManager::WebServerManager() : server(80) {
-    dryingPtr = nullptr;
-    currentWeightPtr = nullptr;
+WebServerManager::WebServerManager() : server(80), events("/events") {
+    serverStarted = false;
+    memset(&lastPushed, 0, sizeof(lastPushed));
+    hasPushed = false;
+    pushedGeneration = 0;
+    eventSeq = 0;
+    lastPushTime = 0;
+    storagePtr = nullptr;
+    jobsPtr = nullptr;
+    apiToken = "";
+    activeRequests = 0;
 }
 
-void WebServerManager::init(DryingSessionManager* dryingMgr, float* currentWeight) {
-    dryingPtr = dryingMgr;
-    currentWeightPtr = currentWeight;
-    
-    Serial.println("[WebServer] Initialized with pointers");
+void WebServerManager::init(StorageManager* storageMgr, SampleLog* samples) {
+    storagePtr = storageMgr;
+    api.begin(esp_random(), samples, storageMgr ? loadArchive : nullptr, storageMgr);
 }
 
-bool WebServerManager::begin(const char* ssid, const char* password) {
-    if (!dryingPtr || !currentWeightPtr) {
-        Serial.println("[WebServer] ERROR: Not initialized! Call init() first.");
-        return false;
+bool WebServerManager::loadArchive(void* context, uint16_t id, DryingSession& session) {
+    return static_cast<StorageManager*>(context)->loadArchive(id, session);
+}
+
+void WebServerManager::enableControl(JobManager* jobManager, const char* token) {
+    jobsPtr = jobManager;
+    apiToken = token ? token : "";
+    if (apiToken[0] == '\0') {
+        Serial.println("[WebServer] API_TOKEN not set - control API disabled");
     }
-    
-    Serial.println("\n[WebServer] Connecting to WiFi...");
-    Serial.printf("[WebServer] SSID: %s\n", ssid);
-    
-    WiFi.mode(WIFI_OFF);
-    delay(1000);
-    WiFi.mode(WIFI_STA);
-    delay(1000);
-    
-    for (int attempt = 1; attempt <= 3; attempt++) {
-        Serial.printf("[WebServer] Connection attempt %d/3\n", attempt);
-        
-        WiFi.begin(ssid, password);
-        delay(1000);
-        
-        int attempts = 0;
-        const int maxAttempts = 40;
-        
-        while (attempts < maxAttempts) {
-            int strength = WiFi.RSSI();
-            
-            if (WiFi.status() == WL_CONNECTED && strength < 0) {
-                Serial.println("\n[WebServer] WiFi connected!");
-                Serial.print("[WebServer] IP Address: ");
-                Serial.println(WiFi.localIP());
-                Serial.printf("[WebServer] Signal strength (RSSI): %d dBm\n", strength);
-                
-                setupRoutes();
-                server.begin();
-                
-                Serial.println("[WebServer] HTTP server started");
-                return true;
-            }
-            
-            delay(500);
-            Serial.print(".");
-            attempts++;
-            
-            if (attempts % 10 == 0) {
-                Serial.printf("\n[WebServer] Status: %d, RSSI: %d\n", WiFi.status(), strength);
-            }
-        }
-        
-        if (WiFi.RSSI() == 0 && attempt < 3) {
-            Serial.println("\n[WebServer] Signal strength is 0, retrying...");
-            WiFi.disconnect(true);
-            delay(1000);
-        } else {
-            break;
-        }
+}
+
+// Вика се от loop(), след като NetworkManager получи IP
+void WebServerManager::begin() {
+    if (serverStarted) {
+        return;
     }
-    
-    Serial.println("\n[WebServer] WiFi connection FAILED!");
-    return false;
+
+    setupRoutes();
+    server.begin();
+    serverStarted = true;
+
+    Serial.println("[WebServer] HTTP server started");
 }
 
 void WebServerManager::setupRoutes() {
-    // Синхронен WebServer - [this] работи перфектно!
-    server.on("/", HTTP_GET, [this]() {
-        handleMonitorPage();
+    // Async сървър - handler-ите вървят в async_tcp задачата, не в loop()
+    server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_MONITOR_PAGE, request, &WebServerManager::handleMonitorPage);
+    });
+    
+    server.on("/history", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_HISTORY_PAGE, request, &WebServerManager::handleHistoryPage);
+    });
+    
+    server.on("/status/data", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_STATUS_DATA, request, &WebServerManager::handleStatusData);
     });
     
-    server.on("/history", HTTP_GET, [this]() {
-        handleHistoryPage();
+    server.on("/history/data", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_HISTORY_DATA, request, &WebServerManager::handleHistoryData);
     });
     
-    server.on("/status/data", HTTP_GET, [this]() {
-        handleStatusData();
+    server.on("/history/sessions", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_HISTORY_SESSIONS, request, &WebServerManager::handleSessionList);
     });
     
-    server.on("/history/data", HTTP_GET, [this]() {
-        handleHistoryData();
+    server.on("/series", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_SERIES, request, &WebServerManager::handleSeries);
+    });
+    
+    server.on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_METRICS, request, &WebServerManager::handleMetrics);
+    });
+    
+    // Управление: POST -> 202 + id на задача, прогресът е в /api/jobs?id=
+    static const struct {
+        const char* uri;
+        JobManager::JobType type;
+    } CONTROL_ROUTES[] = {
+        { "/api/tare",          JobManager::JOB_TARE },
+        { "/api/session/start", JobManager::JOB_START_SESSION },
+        { "/api/session/stop",  JobManager::JOB_STOP_SESSION },
+        { "/api/record",        JobManager::JOB_RECORD_NOW },
+        { "/api/calibrate",     JobManager::JOB_CALIBRATE },
+    };
+    for (const auto& route : CONTROL_ROUTES) {
+        JobManager::JobType type = route.type;
+        server.on(route.uri, HTTP_POST, [this, type](AsyncWebServerRequest* request) {
+            TRACE_SCOPE(httpRouteName(ROUTE_API_CONTROL));
+            unsigned long start = micros();
+            handleControl(request, type);
+            metrics.httpRequests[ROUTE_API_CONTROL].inc();
+            metrics.httpLatencyUs[ROUTE_API_CONTROL].observe(micros() - start);
+        });
+    }
+    
+    server.on("/api/jobs", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_API_JOBS, request, &WebServerManager::handleJobStatus);
+    });
+    
+    // Фазите от ring buffer-а на Trace (chrome://tracing, ui.perfetto.dev)
+    server.on("/trace", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTimed(ROUTE_TRACE, request, &WebServerManager::handleTrace);
+    });
+    
+    // Push канал за монитора - при свързване клиентът получава пълния
+    // статус, после делтите от poll-а на връзката му (async_tcp задачата)
+    events.onConnect([this](AsyncEventSourceClient* client) {
+        if (events.count() > MAX_EVENT_CLIENTS) {
+            client->close();
+            return;
+        }
+        const char* json = api.getStatusJSON(getGeneration());
+        metrics.jsonBytes.inc(strlen(json));
+        client->send(json, "status", eventSeq, 5000);
+        client->client()->onPoll([this, client](void*, AsyncClient*) { pollEvents(client); });
+    });
+    server.addHandler(&events);
+    
+    server.onNotFound([](AsyncWebServerRequest* request) {
+        request->send(404, "text/plain", "Not found");
+    });
+}
+
+void WebServerManager::handleTimed(HttpRoute route, AsyncWebServerRequest* request,
+                                   void (WebServerManager::*handler)(AsyncWebServerRequest*)) {
+    // Мери се времето в handler-а (изпращането е асинхронно)
+    TRACE_SCOPE(httpRouteName(route));
+    unsigned long start = micros();
+    (this->*handler)(request);
+    metrics.httpRequests[route].inc();
+    metrics.httpLatencyUs[route].observe(micros() - start);
+}
+
+bool WebServerManager::admitRequest(AsyncWebServerRequest* request) {
+    // Ограничена "опашка" - над лимита отговаряме веднага с 503
+    if (activeRequests >= MAX_CONCURRENT_REQUESTS) {
+        metrics.httpRejected.inc();
+        AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "Busy");
+        response->addHeader("Retry-After", "1");
+        request->send(response);
+        return false;
+    }
+    
+    activeRequests++;
+    request->onDisconnect([this]() {
+        if (activeRequests > 0) {
+            activeRequests--;
+        }
     });
+    
+    // Бавен клиент не може да държи връзката безкрайно
+    request->client()->setRxTimeout(REQUEST_RX_TIMEOUT_SEC);
+    request->client()->setAckTimeout(REQUEST_ACK_TIMEOUT_MS);
+    return true;
 }
 
 // Handler функции
-void WebServerManager::handleMonitorPage() {
-    server.send(200, "text/html", MONITOR_PAGE);
+void WebServerManager::handleMonitorPage(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
+    sendAsset(request, WEB_ASSET_MONITOR);
+}
+
+void WebServerManager::handleHistoryPage(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
+    sendAsset(request, WEB_ASSET_HISTORY);
 }
 
-void WebServerManager::handleHistoryPage() {
-    server.send(200, "text/html", HISTORY_PAGE);
+const char* WebServerManager::ifNoneMatch(AsyncWebServerRequest* request) {
+    return request->hasHeader("If-None-Match") ? request->getHeader("If-None-Match")->value().c_str() : "";
 }
 
-void WebServerManager::handleStatusData() {
-    server.send(200, "application/json", getStatusJSON());
+bool WebServerManager::notModified(AsyncWebServerRequest* request, const char* etag) {
+    // Браузърът вече има тази версия - само 304, без тяло
+    if (strstr(ifNoneMatch(request), etag) == nullptr) {
+        return false;
+    }
+    
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    request->send(response);
+    return true;
+}
+
+void WebServerManager::sendAsset(AsyncWebServerRequest* request, const WebAsset& asset) {
+    if (notModified(request, asset.etag)) return;
+    
+    // Компресираните байтове се пращат директно от flash, на части
+    AsyncWebServerResponse* response = request->beginResponse_P(200, asset.contentType, asset.data, asset.length);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", "no-cache");  // Винаги валидиране с ETag
+    request->send(response);
+}
+
+void WebServerManager::sendJson(AsyncWebServerRequest* request, int code, const char* json, const char* etag) {
+    metrics.jsonBytes.inc(strlen(json));
+    if (!etag) {
+        request->send(code, "application/json", json);
+        return;
+    }
+    
+    AsyncWebServerResponse* response = request->beginResponse(code, "application/json", json);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
 }
 
-void WebServerManager::handleHistoryData() {
-    server.send(200, "application/json", getHistoryJSON());
+// Параметрите от URL-а обратно в "a=1&b=2" за ApiHandler (стойностите
+// са вече декодирани); false, ако не се събират
+bool WebServerManager::getQuery(AsyncWebServerRequest* request, char* out, size_t size) {
+    size_t length = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < request->params(); i++) {
+        AsyncWebParameter* param = request->getParam(i);
+        if (param->isPost() || param->isFile()) {
+            continue;
+        }
+        int n = snprintf(out + length, size - length, "%s%s=%s", length > 0 ? "&" : "",
+                         param->name().c_str(), param->value().c_str());
+        if (n < 0 || (size_t)n >= size - length) {
+            return false;
+        }
+        length += n;
+    }
+    return true;
 }
 
-// Helper функции
-String WebServerManager::getStatusJSON() {
-    if (!dryingPtr || !currentWeightPtr) {
-        return "{\"error\":\"Not initialized\"}";
+// /status/data, /history/data и /series - отговорът е от ApiHandler
+void WebServerManager::handleApi(AsyncWebServerRequest* request, ApiRoute route) {
+    if (!admitRequest(request)) return;
+    
+    char query[128];
+    if (!getQuery(request, query, sizeof(query))) {
+        request->send(400, "application/json", "{\"error\":\"Bad query\"}");
+        return;
     }
     
-    // Статични променливи за кеширане
-    static float lastSentWeight = 0.0f;
-    static String cachedJson = "";
-    static unsigned long lastUpdate = 0;
-    static bool lastActiveState = false;
+    ApiResponse response;
+    api.handle(route, query, ifNoneMatch(request), response);
     
-    const float WEIGHT_UPDATE_THRESHOLD = 1.0f;  // 1 грам буфер, както при дисплея
-    const unsigned long FORCE_UPDATE_INTERVAL = 5000;  // Форсирано обновяване на 5 сек
+    if (response.code == 304) {
+        AsyncWebServerResponse* notModified = request->beginResponse(304);
+        notModified->addHeader("ETag", response.etag);
+        request->send(notModified);
+        return;
+    }
+    if (response.code == 500) {
+        Serial.printf("[WebServer] %s JSON truncated!\n", request->url().c_str());
+    }
+    sendJson(request, response.code, response.body, response.etag[0] ? response.etag : nullptr);
+}
+
+void WebServerManager::handleStatusData(AsyncWebServerRequest* request) {
+    handleApi(request, API_STATUS);
+}
+
+void WebServerManager::handleHistoryData(AsyncWebServerRequest* request) {
+    handleApi(request, API_HISTORY);
+}
+
+void WebServerManager::handleSessionList(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
     
-    unsigned long now = millis();
-    bool isActive = dryingPtr->isActive();
-    float currentW = *currentWeightPtr;
-    
-    // Проверка дали трябва да обновим JSON
-    bool needsUpdate = false;
-    
-    // 1. Форсирано обновяване на всеки 5 сек
-    if (now - lastUpdate >= FORCE_UPDATE_INTERVAL) {
-        needsUpdate = true;
-    }
-    
-    // 2. Промяна на статус (активна/неактивна сесия)
-    if (isActive != lastActiveState) {
-        needsUpdate = true;
-        lastActiveState = isActive;
-    }
-    
-    // 3. Значителна промяна на теглото (>=1g)
-    if (isActive && abs(currentW - lastSentWeight) >= WEIGHT_UPDATE_THRESHOLD) {
-        needsUpdate = true;
-    }
-    
-    // 4. Първо извикване (празен кеш)
-    if (cachedJson.isEmpty()) {
-        needsUpdate = true;
-    }
-    
-    // Генериране на нов JSON само при нужда
-    if (needsUpdate) {
-        String json = "{";
-        json += "\"active\":" + String(isActive ? "true" : "false") + ",";
-        
-        if (isActive) {
-            DryingSession& session = dryingPtr->getSession();
-            
-            float realtimeLoss = 0.0f;
-            if (session.initialWeight > 0) {
-                float totalLoss = session.initialWeight - currentW;
-                realtimeLoss = (totalLoss / session.initialWeight) * 100.0f;
-            }
-            
-            json += "\"initialWeight\":" + String(session.initialWeight, 1) + ",";
-            json += "\"currentWeight\":" + String(currentW, 1) + ",";
-            json += "\"targetLoss\":" + String(session.targetLossPercent, 1) + ",";
-            json += "\"currentLoss\":" + String(realtimeLoss, 1) + ",";
-            json += "\"currentDay\":" + String(session.currentDay) + ",";
-            json += "\"recordCount\":" + String(session.recordCount) + ",";
-            
-            int daysRemaining = dryingPtr->estimateDaysRemaining();
-            json += "\"daysRemaining\":" + String(daysRemaining) + ",";
-            json += "\"isReady\":" + String(dryingPtr->isReady() ? "true" : "false");
-            
-            lastSentWeight = currentW;  // Запази последното изпратено тегло
-        } else {
-            json += "\"initialWeight\":0,";
-            json += "\"currentWeight\":0,";
-            json += "\"targetLoss\":0,";
-            json += "\"currentLoss\":0,";
-            json += "\"currentDay\":0,";
-            json += "\"recordCount\":0,";
-            json += "\"daysRemaining\":0,";
-            json += "\"isReady\":false";
-            
-            lastSentWeight = 0.0f;
+    // Архив се добавя само при край на сесия, което сменя поколението
+    ApiResponse response;
+    if (api.checkEtag(getGeneration(), ifNoneMatch(request), response)) {
+        notModified(request, response.etag);
+        return;
+    }
+    
+    SessionArchiveInfo sessions[StorageManager::MAX_ARCHIVES];
+    uint8_t count = storagePtr ? storagePtr->listArchives(sessions, StorageManager::MAX_ARCHIVES) : 0;
+    
+    JsonWriter json(api.getBulkBuffer(), api.getBulkSize());
+    writeSessionListJson(json, sessions, count);
+    sendJson(request, 200, api.getBulkBuffer(), response.etag);
+}
+
+void WebServerManager::handleSeries(AsyncWebServerRequest* request) {
+    handleApi(request, API_SERIES);
+}
+
+void WebServerManager::handleMetrics(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
+    
+    MetricsGauges gauges;
+    gauges.uptimeSec = DryingSessionManager::uptimeSeconds();
+    gauges.freeHeap = ESP.getFreeHeap();
+    gauges.minFreeHeap = ESP.getMinFreeHeap();
+    gauges.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    gauges.wifiConnected = WiFi.status() == WL_CONNECTED;
+    gauges.wifiRssi = gauges.wifiConnected ? WiFi.RSSI() : 0;
+    MetricsTask tasks[METRICS_MAX_TASKS];
+    gauges.tasks = tasks;
+    gauges.taskCount = taskMonitor.snapshot(tasks, METRICS_MAX_TASKS);
+    
+    if (writeMetrics(api.getBulkBuffer(), api.getBulkSize(), metrics, gauges) == 0) {
+        Serial.println("[WebServer] Metrics truncated!");
+        request->send(500, "text/plain", "Metrics buffer too small");
+        return;
+    }
+    request->send(200, "text/plain; version=0.0.4", api.getBulkBuffer());
+}
+
+// Последните събития, колкото се събират в буфера (serial "trace" дава всички)
+void WebServerManager::handleTrace(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
+    
+    if (traceBuffer.writeJson(api.getBulkBuffer(), api.getBulkSize()) == 0) {
+        request->send(500, "text/plain", "Trace buffer too small");
+        return;
+    }
+    request->send(200, "application/json", api.getBulkBuffer());
+}
+
+// Authorization: Bearer <API_TOKEN>
+bool WebServerManager::authorize(AsyncWebServerRequest* request) {
+    if (!jobsPtr || apiToken[0] == '\0') {
+        request->send(403, "application/json", "{\"error\":\"Control API disabled\"}");
+        return false;
+    }
+    
+    const char* given = "";
+    if (request->hasHeader("Authorization")) {
+        const String& header = request->getHeader("Authorization")->value();
+        if (header.startsWith("Bearer ")) {
+            given = header.c_str() + 7;
+        }
+    }
+    
+    // Сравнение с постоянно време - дължината на token-а не изтича
+    size_t expectedLen = strlen(apiToken);
+    size_t givenLen = strlen(given);
+    uint8_t diff = expectedLen != givenLen;
+    for (size_t i = 0; i < expectedLen; i++) {
+        diff |= apiToken[i] ^ (i < givenLen ? given[i] : 0);
+    }
+    
+    if (diff != 0) {
+        AsyncWebServerResponse* response = request->beginResponse(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        response->addHeader("WWW-Authenticate", "Bearer");
+        request->send(response);
+        return false;
+    }
+    return true;
+}
+
+// Параметър от тялото (form) или от URL-а
+bool WebServerManager::getFloatParam(AsyncWebServerRequest* request, const char* name, float& value) {
+    if (request->hasParam(name, true)) {
+        value = request->getParam(name, true)->value().toFloat();
+        return true;
+    }
+    if (request->hasParam(name)) {
+        value = request->getParam(name)->value().toFloat();
+        return true;
+    }
+    return false;
+}
+
+void WebServerManager::handleControl(AsyncWebServerRequest* request, JobManager::JobType type) {
+    if (!admitRequest(request)) return;
+    if (!authorize(request)) return;
+    
+    float param = 0.0f;
+    if (type == JobManager::JOB_START_SESSION) {
+        param = 40.0f;  // Като при START бутона
+        if (getFloatParam(request, "target", param) && (param <= 0.0f || param >= 100.0f)) {
+            request->send(400, "application/json", "{\"error\":\"target must be 0-100\"}");
+            return;
         }
-        
-        json += "}";
-        
-        cachedJson = json;
-        lastUpdate = now;
-    }
-    
-    return cachedJson;
-}
-
-String WebServerManager::getHistoryJSON() {
-    if (!dryingPtr) {
-        return "{\"error\":\"Not initialized\"}";
-    }
-    
-    String json = "{";
-    json += "\"active\":" + String(dryingPtr->isActive() ? "true" : "false") + ",";
-    json += "\"records\":[";
-    
-    if (dryingPtr->isActive()) {
-        int count = dryingPtr->getRecordCount();
-        for (int i = 0; i < count; i++) {
-            DailyRecord* record = dryingPtr->getRecord(i);
-            if (record) {
-                if (i > 0) json += ",";
-                json += "{";
-                json += "\"day\":" + String(record->day) + ",";
-                json += "\"weight\":" + String(record->weight, 1) + ",";
-                json += "\"loss\":" + String(record->lossPercent, 1) + ",";
-                json += "\"change\":" + String(record->dayChange, 1);
-                json += "}";
-            }
+    } else if (type == JobManager::JOB_CALIBRATE) {
+        if (!getFloatParam(request, "weight", param) || param <= 0.0f) {
+            request->send(400, "application/json", "{\"error\":\"weight required\"}");
+            return;
         }
     }
     
-    json += "]}";
-    return json;
+    uint16_t id = jobsPtr->submit(type, param);
+    if (id == 0) {
+        AsyncWebServerResponse* response = request->beginResponse(503, "application/json", "{\"error\":\"Job queue full\"}");
+        response->addHeader("Retry-After", "5");
+        request->send(response);
+        return;
+    }
+    
+    char location[32];
+    snprintf(location, sizeof(location), "/api/jobs?id=%u", id);
+    
+    char buf[128];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("id", (uint32_t)id);
+    json.field("type", JobManager::typeName(type));
+    json.field("state", JobManager::stateName(JobManager::JOB_QUEUED));
+    json.field("poll", location);
+    json.endObject();
+    
+    metrics.jsonBytes.inc(json.length());
+    AsyncWebServerResponse* response = request->beginResponse(202, "application/json", buf);
+    response->addHeader("Location", location);
+    request->send(response);
+}
+
+void WebServerManager::handleJobStatus(AsyncWebServerRequest* request) {
+    if (!admitRequest(request)) return;
+    if (!authorize(request)) return;
+    
+    JobManager::Job job;
+    long id = request->hasParam("id") ? request->getParam("id")->value().toInt() : 0;
+    if (id <= 0 || id > 0xFFFF || !jobsPtr->getJob(id, job)) {
+        request->send(404, "application/json", "{\"error\":\"Unknown job\"}");
+        return;
+    }
+    
+    char buf[160];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    json.field("id", (uint32_t)job.id);
+    json.field("type", JobManager::typeName(job.type));
+    json.field("state", JobManager::stateName(job.state));
+    json.field("progress", (uint32_t)job.progress);
+    json.field("message", job.message);
+    json.endObject();
+    
+    sendJson(request, 200, buf);
 }
 
-void WebServerManager::handle() {
-    server.handleClient();  // ВАЖНО: Извикваме в loop()
+// Snapshot
+void WebServerManager::publish(const SystemState& state, DryingSessionManager& drying) {
+    SystemSnapshot sys;
+    if (!state.read(sys)) {
+        return;
+    }
+    
+    StatusSnapshot next;
+    memset(&next, 0, sizeof(next));
+    next.active = sys.sessionActive;
+    
+    if (next.active) {
+        next.initialWeight = sys.initialWeight;
+        next.currentWeight = sys.weight;
+        next.targetLoss = sys.targetLoss;
+        next.currentDay = sys.currentDay;
+        next.recordCount = sys.recordCount;
+        next.daysRemaining = sys.daysRemaining;
+        next.isReady = sys.isReady;
+    }
+    
+    // Филтрирано тегло - шумът под прага не е промяна на състоянието.
+    // SSE делтата се прави от този snapshot в async_tcp (pushChanges)
+    api.publishStatus(next);
+    
+    // Записите се копират само при промяна, без да чакаме HTTP задачата
+    DryingSession& session = drying.getSession();
+    api.publishRecords(session.records, session.recordCount, session.isActive, session.startTimestamp);
 }
 
-bool WebServerManager::isConnected() {
-    return WiFi.status() == WL_CONNECTED;
+// Заменя poll-а на библиотеката за връзката. Той само довършва опашката
+// на клиента, затова и тук: write() на празен SSE коментар я пуска.
+void WebServerManager::pollEvents(AsyncEventSourceClient* client) {
+    pushChanges();
+    if (client->packetsWaiting() > 0) {
+        client->write(":\n", 2);
+    }
 }
 
-String WebServerManager::getIPAddress() {
-    return WiFi.localIP().toString();
-}
\ No newline at end of file
+// Само в async_tcp задачата - там ESPAsyncWebServer променя и списъка с
+// клиенти, така че events.send() не се засича с него
+void WebServerManager::pushChanges() {
+    unsigned long now = millis();
+    if (now - lastPushTime < PUSH_MIN_INTERVAL) return;
+    
+    // Без нов publish() няма какво да се сравнява
+    uint32_t generation = getGeneration();
+    if (hasPushed && generation == pushedGeneration) return;
+    
+    // loop() пише в момента - следващият poll
+    StatusSnapshot snap;
+    if (!api.readStatus(snap)) return;
+    
+    // Делтата съдържа само променените полета (същите ключове като /status/data)
+    bool all = !hasPushed || snap.active != lastPushed.active;
+    bool weightChanged = all || abs(snap.currentWeight - lastPushed.currentWeight) >= PUSH_WEIGHT_THRESHOLD;
+    
+    char buf[256];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject();
+    
+    if (all) {
+        json.field("active", snap.active);
+    }
+    if (all || snap.initialWeight != lastPushed.initialWeight) {
+        json.field("initialWeight", snap.initialWeight, 1);
+    }
+    if (all || snap.targetLoss != lastPushed.targetLoss) {
+        json.field("targetLoss", snap.targetLoss, 1);
+    }
+    if (weightChanged) {
+        json.field("currentWeight", snap.currentWeight, 1);
+        json.field("currentLoss", realtimeLossPercent(snap.initialWeight, snap.currentWeight), 1);
+    }
+    if (all || snap.currentDay != lastPushed.currentDay) {
+        json.field("currentDay", (int32_t)snap.currentDay);
+    }
+    if (all || snap.recordCount != lastPushed.recordCount) {
+        json.field("recordCount", (int32_t)snap.recordCount);
+    }
+    if (all || snap.daysRemaining != lastPushed.daysRemaining) {
+        json.field("daysRemaining", (int32_t)snap.daysRemaining);
+    }
+    if (all || snap.isReady != lastPushed.isReady) {
+        json.field("isReady", snap.isReady);
+    }
+    
+    pushedGeneration = generation;
+    if (json.length() <= 1) {
+        return;  // Няма промяна (новите записи не влизат в делтата)
+    }
+    json.endObject();
+    if (json.overflowed()) {
+        Serial.println("[WebServer] Delta too large, dropped");
+        return;
+    }
+    
+    // Запомняме какво е изпратено; теглото - само ако е включено в делтата
+    float sentWeight = weightChanged ? snap.currentWeight : lastPushed.currentWeight;
+    lastPushed = snap;
+    lastPushed.currentWeight = sentWeight;
+    hasPushed = true;
+    lastPushTime = now;
+    
+    // Вика се от poll на клиент, така че има поне един; новите получават
+    // пълен статус. Опашката на всеки клиент е ограничена
+    // (SSE_MAX_QUEUED_MESSAGES). Изпуснато съобщение се вижда в браузъра
+    // като пропуснат id.
+    metrics.jsonBytes.inc(json.length());
+    events.send(buf, "delta", ++eventSeq);
+}
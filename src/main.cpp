@@ -6,6 +6,20 @@
 #include "DisplayManager.h"
 #include "ButtonHandler.h"
 #include "WebServerManager.h"
+#include "NetworkManager.h"
+#include "AlertManager.h"
+#include "SampleLog.h"
+#include "Metrics.h"
+#include "JobManager.h"
+#include "SystemState.h"
+#include "UiController.h"
+#include "Sampler.h"
+#include "TaskMonitor.h"
+#include "EventBus.h"
+#include "Trace.h"
+#ifdef MICROBENCH
+#include "MicroBench.h"
+#endif
 #include "secrets.h"
 
 
@@ -26,6 +40,19 @@
 #define I2C_SDA           21
 #define I2C_SCL           22
 
+// Зумер за аларми
+#define BUZZER_PIN        27
+
+// Webhook за аларми (по избор, дефинира се в secrets.h)
+#ifndef ALERT_WEBHOOK_URL
+#define ALERT_WEBHOOK_URL ""
+#endif
+
+// Token за POST /api/* (по избор, дефинира се в secrets.h; празен = изключено)
+#ifndef API_TOKEN
+#define API_TOKEN ""
+#endif
+
 // ============================================================================
 // === GLOBAL OBJECTS ===
 // ============================================================================
@@ -35,39 +62,109 @@ StorageManager storage;
 DryingSessionManager drying(storage);
 DisplayManager display;
 ButtonHandler buttons(BTN_TARE_PIN, BTN_UNIT_PIN, BTN_START_PIN);
+AlertManager alerts(BUZZER_PIN);
+SampleLog sampleLog;   // Минутни проби за графиките (последните 24 ч, само в RAM)
+JobManager jobs;       // Операции от web API, изпълнявани от loop()
+SystemState systemState;        // Snapshot за задачите извън loop()
+StabilityTracker stability;
+UiController ui(display, buttons, drying, scale);   // Съобщения, екрани, графики
+Sampler sampler(scale);         // Задачата, която чете HX711
 
 // ============================================================================
-// === TIMING ===
+// === ALERT RULES ===
 // ============================================================================
 
-unsigned long lastWeightRead = 0;
-unsigned long lastDisplayUpdate = 0;
-unsigned long messageDisplayTime = 0;
+const AlertManager::RuleConfig ALERT_RULES[] = {
+    // name      type                         value  window      actions                                                                     debounce  interval
+    { "ready",   AlertManager::ALERT_READY,     0.0f,  0,         AlertManager::ACTION_BANNER | AlertManager::ACTION_BUZZER | AlertManager::ACTION_WEBHOOK, 60000,  6UL * 3600000 },
+    { "loss30",  AlertManager::ALERT_THRESHOLD, 30.0f, 0,         AlertManager::ACTION_BANNER | AlertManager::ACTION_WEBHOOK,                                60000,  24UL * 3600000 },
+    { "fast",    AlertManager::ALERT_RATE,      3.0f,  0,         AlertManager::ACTION_BANNER | AlertManager::ACTION_WEBHOOK,                                0,      24UL * 3600000 },
+    { "stall",   AlertManager::ALERT_STALL,     2.0f,  12 * 3600, AlertManager::ACTION_BANNER | AlertManager::ACTION_WEBHOOK,                                0,      12UL * 3600000 },
+    { "jump",    AlertManager::ALERT_ANOMALY,   50.0f, 0,         AlertManager::ACTION_BANNER | AlertManager::ACTION_BUZZER | AlertManager::ACTION_WEBHOOK, 900000, 60000 },
+};
 
-const unsigned long WEIGHT_READ_INTERVAL = 500;
-const unsigned long DISPLAY_UPDATE_INTERVAL = 500;
-const unsigned long MESSAGE_DISPLAY_DURATION = 2000;
+// ============================================================================
+// === TIMING ===
+// ============================================================================
 
-float currentWeight = 0.0f;
-float lastDisplayedWeight = 0.0f;
-bool showingMessage = false;
+// loop() е задачата на сесията и UI-я (core 1, приоритет 1): чака проба
+// от Sampler най-много толкова, после обработва бутони, web заявки и екрана
+const uint32_t LOOP_IDLE_MS = 10;
 
-const float DISPLAY_UPDATE_THRESHOLD = 1.0f;
+float currentWeight = 0.0f;
+int8_t loopTaskId = -1;
+bool eventLog = false;      // "events" - събитията на Serial
+uint32_t formatCount = 0;   // Последното видяно StorageManager::getFormatCount()
 
 WebServerManager webServer; 
+NetworkManager network;     // WiFi без блокиране на setup()/loop()
+
+#ifdef MICROBENCH
+MicroBench microBench(scale, storage, display);   // serial "bench" (~21 KB RAM)
+#endif
 
 // ============================================================================
 // === HELPER FUNCTIONS ===
 // ============================================================================
 
-void showTemporaryMessage(String title, String message) {
-    display.showMessage(title, message, 0);
-    showingMessage = true;
-    messageDisplayTime = millis();
+// Един snapshot на минаване на loop(); всички останали задачи четат него
+void publishSystemState() {
+    SystemSnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    
+    snap.timestampMs = millis();
+    snap.weight = currentWeight;
+    snap.weightValid = metrics.scaleSamplesRead.get() > 0;
+    snap.stable = stability.isStable();
+    snap.operationMode = buttons.getMode();
+    snap.displayMode = display.getMode();
+    snap.daysRemaining = -1;
+    
+    if (drying.isActive()) {
+        DryingSession& session = drying.getSession();
+        snap.sessionActive = true;
+        snap.initialWeight = session.initialWeight;
+        snap.targetLoss = session.targetLossPercent;
+        snap.lastRecordLoss = drying.getCurrentLossPercent();
+        snap.currentDay = session.currentDay;
+        snap.recordCount = session.recordCount;
+        snap.daysRemaining = drying.estimateDaysRemaining();
+        snap.isReady = drying.isReady();
+    }
+    
+    systemState.publish(snap);
 }
 
-void forceDisplayUpdate() {
-    lastDisplayUpdate = 0;
+// ============================================================================
+// === EVENTS ===
+// ============================================================================
+
+// Кой слуша кое събитие. Нов консуматор (метрики, лог, MQTT) се добавя
+// тук, без промяна в модула, който публикува.
+void subscribeEvents() {
+    // Проба от Sampler: стабилност, графики, аларми
+    EventBus::subscribe<WeightSampleEvent>([](const WeightSampleEvent& e, void*) {
+        stability.add(e.weight);
+        sampleLog.addReading(e.timestampMs / 1000, e.weight);
+        ui.addSample(e.timestampMs / 1000, e.weight);
+        alerts.evaluate(drying, e.weight);
+    });
+    
+    EventBus::subscribe<RecordAddedEvent>([](const RecordAddedEvent& e, void*) {
+        if (eventLog) Serial.printf("[Event] record day=%u weight=%.1f loss=%.1f\n", e.day, e.weight, e.lossPercent);
+    });
+    EventBus::subscribe<SessionStartedEvent>([](const SessionStartedEvent& e, void*) {
+        if (eventLog) Serial.printf("[Event] session start initial=%.1f target=%.1f\n", e.initialWeight, e.targetLossPercent);
+    });
+    EventBus::subscribe<SessionEndedEvent>([](const SessionEndedEvent& e, void*) {
+        if (eventLog) Serial.printf("[Event] session end records=%u loss=%.1f\n", e.recordCount, e.lossPercent);
+    });
+    EventBus::subscribe<TareDoneEvent>([](const TareDoneEvent& e, void*) {
+        if (eventLog) Serial.printf("[Event] tare offset=%ld\n", e.offset);
+    });
+    EventBus::subscribe<AnomalyDetectedEvent>([](const AnomalyDetectedEvent& e, void*) {
+        if (eventLog) Serial.printf("[Event] anomaly '%s' jump=%+.0f weight=%.1f\n", e.rule, e.jump, e.weight);
+    });
 }
 
 // ============================================================================
@@ -81,78 +178,85 @@ void setup() {
     Wire.begin(I2C_SDA, I2C_SCL);
     
     Serial.println("\n[Setup] Initializing components...");
+    subscribeEvents();
     
     // Display
     if (!display.begin()) {
         Serial.println("[Setup] Display initialization FAILED!");
         while(1);
     }
-    showTemporaryMessage("", "Starting...");
+    ui.showMessage("", "Starting...");
     
     // Scale
     scale.begin();
     if (!scale.isCalibrated()) {
         Serial.println("[Setup] WARNING: Scale not calibrated!");
-        showTemporaryMessage("Warning", "Not calibrated");
+        ui.showMessage("Warning", "Not calibrated");
     }
     
     // Storage
     if (!storage.begin()) {
         Serial.println("[Setup] Storage initialization FAILED!");
-        showTemporaryMessage("Error", "Storage failed");
+        ui.showMessage("Error", "Storage failed");
     }
     
     // Drying Session
     drying.begin();
+    // Сесията е заредена - оттук записите във флаша са във фонова задача
+    storage.startFlushTask();
+    
+    // Аларми
+    alerts.begin(ALERT_RULES, sizeof(ALERT_RULES) / sizeof(ALERT_RULES[0]), ALERT_WEBHOOK_URL);
     
     // Buttons
     buttons.begin();
 
-    // === НОВА ИНИЦИАЛИЗАЦИЯ ===
-    // Първо инициализирай указателите
-    webServer.init(&drying, &currentWeight);
-    
-    // След това стартирай WiFi
-    if (webServer.begin(WIFI_SSID, WIFI_PASSWORD)) {
-        Serial.println("[Setup] Web server started successfully!");
-        Serial.print("[Setup] Access at: http://");
-        Serial.println(webServer.getIPAddress());
-    } else {
-        Serial.println("[Setup] Web server failed to start!");
-    }
+    // WiFi се свързва във фона; HTTP сървърът тръгва от loop() при първия IP
+    webServer.init(&storage, &sampleLog);
+    webServer.enableControl(&jobs, API_TOKEN);
+    network.setConnectedWork(AlertManager::webhookWork, &alerts);
+    network.begin(WIFI_SSID, WIFI_PASSWORD);
     
     // Проверка дали има активна сесия
     if (drying.isActive()) {
         Serial.println("[Setup] Active drying session detected!");
         buttons.setMode(ButtonHandler::OP_MODE_DRYING);
         display.setMode(DisplayManager::MODE_DRYING_LIVE);
-        showTemporaryMessage("Resuming", "Active session");
+        ui.showMessage("Resuming", "Active session");
         // НЕ тарираме - има активна сесия!
         currentWeight = scale.getRawWeight();
     } else {
         // Няма активна сесия - тарираме
         scale.performTare();
         currentWeight = 0.0f;
-        lastDisplayedWeight = 0.0f;
         
         Serial.println("[Setup] Starting in NORMAL mode");
         buttons.setMode(ButtonHandler::OP_MODE_NORMAL);
         display.setMode(DisplayManager::MODE_NORMAL);
         
         // Показваме 0.0
-        display.showNormalWeight(0.0f, scale.getUnitString());
+        display.showNormalWeight(0.0f, scale.getUnit());
     }
     
     // Форсирай display update
-    lastDisplayUpdate = 0;
-    lastWeightRead = 0;
+    ui.forceRedraw();
+    
+    // Пробите тръгват след тарирането
+    loopTaskId = taskMonitor.add("loop", xTaskGetCurrentTaskHandle(), xPortGetCoreID(),
+                                 uxTaskPriorityGet(nullptr));
+    if (!sampler.begin()) {
+        ui.showMessage("Error", "Sampler failed");
+    }
     
     Serial.println("\n[Setup] System ready!");
     Serial.println("Commands:");
     Serial.println("  cal 1000  - Calibrate with 1000g");
     Serial.println("  tare      - Tare the scale");
     Serial.println("  format    - Format storage");
-    Serial.println("  info      - Show system info\n");
+    Serial.println("  info      - Show system info");
+    Serial.println("  keys      - Log button edges (scenario format)");
+    Serial.println("  events    - Log bus events");
+    Serial.println("  trace     - Dump loop phases (Chrome trace JSON), 'trace clear' resets\n");
 }
 
 // ============================================================================
@@ -160,12 +264,24 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    unsigned long currentTime = millis();
-
-     webServer.handle(); 
+    // ========== WEIGHT READING ==========
+    // Всички чакащи проби; без проба loop() спи до LOOP_IDLE_MS
+    WeightReading reading;
+    bool sampled = sampler.receive(reading, LOOP_IDLE_MS);
+    TRACE_SCOPE("loop");    // Без чакането на проба
+    unsigned long loopStart = micros();
+    TRACE_BEGIN("samples");
+    while (sampled) {
+        currentWeight = reading.weight;
+        WeightSampleEvent event = { reading.timestampMs, reading.weight };
+        EventBus::publish(event);
+        sampled = sampler.receive(reading, 0);
+    }
+    TRACE_END("samples");
     
     // ========== SERIAL COMMANDS ==========
     if (Serial.available()) {
+        TRACE_SCOPE("serial");
         String command = Serial.readString();
         command.trim();
         
@@ -186,19 +302,19 @@ void loop() {
                     display.showCalibrationResult(false, 5.0);
                 }
                 delay(3000);
-                lastDisplayUpdate = 0; // Форсирай обновяване след калибрация
+                ui.forceRedraw(); // Форсирай обновяване след калибрация
             } else {
                 Serial.println("Invalid weight! Use: cal 1000");
             }
         } 
         else if (command == "tare") {
             scale.performTare();
-            showTemporaryMessage("", "Tared");
+            ui.showMessage("", "Tared");
         }
         else if (command == "format") {
-            showTemporaryMessage("Formatting", "Storage...");
+            // Форматирането е в задачата за запис - краят се вижда по getFormatCount()
+            ui.showMessage("Formatting", "Storage...");
             storage.format();
-            showTemporaryMessage("Format", "Complete");
         }
         else if (command == "info") {
             Serial.println("\n=== SYSTEM INFO ===");
@@ -223,14 +339,40 @@ void loop() {
             }
             
             storage.printFileSystem();
+            display.printStats();
+            taskMonitor.print();
             Serial.println("==================\n");
         }
+        else if (command == "events") {
+            eventLog = !eventLog;
+            Serial.printf("Event log %s\n", eventLog ? "ON" : "OFF");
+        }
+        else if (command == "trace") {
+            // Chrome trace-event JSON - в chrome://tracing или ui.perfetto.dev
+            traceBuffer.printJson(Serial);
+        }
+        else if (command == "trace clear") {
+            traceBuffer.clear();
+            Serial.println("Trace cleared");
+        }
+        else if (command == "keys") {
+            // Запис на бутоните за bench/ui_replay.cpp
+            buttons.setEdgeLog(!buttons.isEdgeLogEnabled());
+        }
+#ifdef MICROBENCH
+        else if (command == "bench") {
+            // loop() спира за ~1-2 s
+            microBench.run();
+            microBench.printJson(Serial);
+            ui.forceRedraw();
+        }
+#endif
         else if (command == "end") {
             if (drying.isActive()) {
                 drying.endSession();
                 buttons.setMode(ButtonHandler::OP_MODE_NORMAL);
                 display.setMode(DisplayManager::MODE_NORMAL);
-                showTemporaryMessage("Session", "Ended");
+                ui.showMessage("Session", "Ended");
                 Serial.println("Session ended");
             }
         }
@@ -239,110 +381,64 @@ void loop() {
         }
     }
     
-    // ========== WEIGHT READING ==========
-    if (currentTime - lastWeightRead >= WEIGHT_READ_INTERVAL) {
-        if (scale.isReady()) {
-            float rawWeight = scale.getRawWeight();
-            if (!isnan(rawWeight)) {
-                currentWeight = rawWeight;
-            }
-        }
-        lastWeightRead = currentTime;
+    // ========== ALERTS ==========
+    TRACE_BEGIN("alerts");
+    char alertTitle[16];
+    char alertMessage[24];
+    if (alerts.popBanner(alertTitle, sizeof(alertTitle), alertMessage, sizeof(alertMessage))) {
+        ui.showMessage(alertTitle, alertMessage);
     }
+    alerts.update();
+    TRACE_END("alerts");
     
-    // ========== MESSAGE TIMEOUT ==========
-    if (showingMessage && (currentTime - messageDisplayTime >= MESSAGE_DISPLAY_DURATION)) {
-        showingMessage = false;
-        lastDisplayUpdate = 0; // Форсирай обновяване
-        lastDisplayedWeight = 0.0f; // Форсирай показване на тегло
+    // ========== WEB JOBS ==========
+    // Една стъпка на минаване - дългите операции не блокират loop()
+    TRACE_BEGIN("jobs");
+    bool jobHeldDisplay = jobs.ownsDisplay();
+    jobs.update(scale, drying, display, buttons, currentWeight);
+    ui.applyRequests(buttons.popUiRequests());
+    if (jobs.popBanner(alertTitle, sizeof(alertTitle), alertMessage, sizeof(alertMessage))) {
+        ui.showMessage(alertTitle, alertMessage);
+    } else if (jobHeldDisplay && !jobs.ownsDisplay()) {
+        ui.forceRedraw();
     }
-
-    // ========== AUTO DAILY RECORD (DRYING MODE) ==========
-if (buttons.getMode() == ButtonHandler::OP_MODE_DRYING && drying.isActive()) {
-    DryingSession& session = drying.getSession();
-    uint32_t currentTimestamp = millis() / 1000;
-    uint32_t elapsed = currentTimestamp - session.lastRecordTimestamp;
+    TRACE_END("jobs");
     
-    // Ако са минали 24 часа (86400 секунди)
-    // ЗА ТЕСТВАНЕ: Използвай 60 секунди вместо 86400
-    if (elapsed >= 86400) {  // 24 часа
-        drying.recordDailyWeight(currentWeight);
-        DailyRecord* lastRecord = drying.getLastRecord();
-
-        if (lastRecord) {
-            showTemporaryMessage("Day " + String(lastRecord->day), 
-                                 "Loss: " + String(lastRecord->lossPercent, 1) + "%");
-            Serial.printf("[Auto] Day %d recorded: %.1fg, Loss: %.1f%%\n", 
-                         lastRecord->day, lastRecord->weight, lastRecord->lossPercent);
-        }
-    }
-}
+    // ========== UI ==========
+    // Изтичане на съобщения, автоматичен дневен запис, обновяване на екрана
+    TRACE_BEGIN("ui");
+    ui.update(currentWeight, jobs.ownsDisplay());
+    TRACE_END("ui");
     
-   // ========== DISPLAY UPDATE ==========
-if (!showingMessage && currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-    ButtonHandler::OperationMode mode = buttons.getMode();
+    // ========== BUTTON HANDLING ==========
+    TRACE_BEGIN("buttons");
+    buttons.update(scale, drying, display);
+    ui.applyRequests(buttons.popUiRequests());
+    TRACE_END("buttons");
     
-    if (mode == ButtonHandler::OP_MODE_NORMAL) {
-        // Normal mode
-        if (!isnan(currentWeight)) {
-            if (abs(currentWeight - lastDisplayedWeight) >= DISPLAY_UPDATE_THRESHOLD) {
-                float displayWeight = currentWeight;
-                String unit = scale.getUnitString();
-                
-                switch(scale.getUnit()) {
-                    case ScaleManager::KILOGRAMS:
-                        displayWeight = currentWeight / 1000.0f;
-                        break;
-                    case ScaleManager::OUNCES:
-                        displayWeight = currentWeight * 0.035274f;
-                        break;
-                    case ScaleManager::POUNDS:
-                        displayWeight = currentWeight * 0.00220462f;
-                        break;
-                    default:
-                        displayWeight = currentWeight;
-                        break;
-                }
-                
-                display.showNormalWeight(displayWeight, unit);
-                lastDisplayedWeight = currentWeight;
-            }
-        }
-    } 
-    else {
-        // Drying mode
-        DisplayManager::DisplayMode displayMode = display.getMode();
-        
-        // Провери дали е форсирано обновяване (lastDisplayUpdate == 0)
-        bool forceUpdate = (lastDisplayUpdate == 0);
-        
-        switch (displayMode) {
-            case DisplayManager::MODE_DRYING_LIVE:
-                // Обнови ако има промяна ИЛИ е форсирано
-                if (forceUpdate || abs(currentWeight - lastDisplayedWeight) >= DISPLAY_UPDATE_THRESHOLD) {
-                    display.showDryingLive(drying, currentWeight);
-                    lastDisplayedWeight = currentWeight;
-                }
-                break;
-                
-            case DisplayManager::MODE_DRYING_STATS:
-                display.showDryingStats(drying);
-                break;
-                
-            case DisplayManager::MODE_DRYING_HISTORY:
-                display.showDryingHistory(drying, buttons.getHistoryIndex());
-                break;
-                
-            default:
-                break;
-        }
-    }
+    // ========== SHARED STATE ==========
+    TRACE_BEGIN("publish");
+    publishSystemState();
     
-    lastDisplayUpdate = currentTime;
-}
+    // ========== NETWORK ==========
+    // WiFi е в задачата на NetworkManager; тук само старт на HTTP сървъра
+    if (network.isConnected() && !webServer.isStarted()) {
+        webServer.begin();
+        Serial.print("[WebServer] Access at: http://");
+        Serial.println(network.getIPAddress());
+    }
     
-    // ========== BUTTON HANDLING ==========
-    buttons.update(scale, drying, display, currentWeight);
+    // ========== WEB SNAPSHOT ==========
+    // HTTP заявките се обслужват от async_tcp задачата и четат само snapshot-а
+    if (storage.getFormatCount() != formatCount) {
+        formatCount = storage.getFormatCount();
+        webServer.invalidateArchives();
+        ui.showMessage("Format", "Complete");
+    }
+    webServer.publish(systemState, drying);
+    TRACE_END("publish");
     
-    delay(10);
+    uint32_t loopUs = micros() - loopStart;
+    metrics.loopTimeUs.observe(loopUs);
+    taskMonitor.addBusy(loopTaskId, loopUs);
 }
\ No newline at end of file